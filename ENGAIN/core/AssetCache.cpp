@@ -0,0 +1,280 @@
+#include "AssetCache.h"
+#include "Logger.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+
+namespace ENGAIN {
+
+namespace {
+    const size_t TEXTURE_BYTES_PER_PIXEL = 4;
+    
+    const char* typeName(AssetCache::AssetType type) {
+        switch (type) {
+            case AssetCache::AssetType::TEXTURE: return "texture";
+            case AssetCache::AssetType::FONT: return "font";
+            case AssetCache::AssetType::FONT_DATA: return "font file";
+        }
+        return "asset";
+    }
+    
+    // A texture belongs to the renderer that created it
+    std::string textureKey(const std::string& normalizedPath, SDL_Renderer* renderer) {
+        return normalizedPath + "@" + std::to_string(reinterpret_cast<uintptr_t>(renderer));
+    }
+    
+    std::string fontKey(const std::string& normalizedPath, int size) {
+        return normalizedPath + ":" + std::to_string(size);
+    }
+    
+    size_t textureBytes(const Texture& texture) {
+        return static_cast<size_t>(texture.getWidth()) * texture.getHeight() * TEXTURE_BYTES_PER_PIXEL;
+    }
+    
+    double secondsSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    
+    template<typename Map>
+    void eraseExpired(Map& entries) {
+        for (auto it = entries.begin(); it != entries.end(); ) {
+            if (it->second.asset.expired()) {
+                it = entries.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    
+    template<typename Map>
+    void collect(const Map& entries, AssetCache::AssetType type, std::vector<AssetCache::AssetInfo>& out) {
+        for (const auto& pair : entries) {
+            long handles = pair.second.asset.use_count();
+            if (handles == 0) continue;
+            out.push_back(AssetCache::AssetInfo{pair.first, type, pair.second.bytes, handles, pair.second.hits});
+        }
+    }
+}
+
+AssetCache::AssetCache()
+    : hits(0),
+      misses(0),
+      failures(0),
+      loadSeconds(0.0) {
+}
+
+AssetCache& AssetCache::getInstance() {
+    static AssetCache instance;
+    return instance;
+}
+
+std::string AssetCache::normalizePath(const std::string& path) {
+    std::error_code error;
+    std::filesystem::path absolute = std::filesystem::absolute(path, error);
+    if (error) {
+        return std::filesystem::path(path).lexically_normal().string();
+    }
+    
+    // weakly_canonical leaves a missing file's path relative if given one
+    std::filesystem::path normalized = std::filesystem::weakly_canonical(absolute, error);
+    return (error ? absolute.lexically_normal() : normalized).string();
+}
+
+std::shared_ptr<Texture> AssetCache::getTexture(const std::string& path, SDL_Renderer* renderer) {
+    std::string normalizedPath = normalizePath(path);
+    std::string key = textureKey(normalizedPath, renderer);
+    std::shared_ptr<Texture> texture = lookupTexture(key);
+    if (texture) return texture;
+    
+    ENGAIN_PROFILE_SCOPE("AssetCache::getTexture");
+    auto start = std::chrono::steady_clock::now();
+    misses++;
+    pruneExpired();
+    
+    texture = std::make_shared<Texture>();
+    if (!texture->loadFromFile(normalizedPath, renderer)) {
+        failures++;
+        return nullptr;
+    }
+    loadSeconds += secondsSince(start);
+    
+    textures[key] = Entry<Texture>{texture, textureBytes(*texture), 0};
+    return texture;
+}
+
+std::shared_ptr<Font> AssetCache::getFont(const std::string& path, int size) {
+    return addFont(path, size, nullptr);
+}
+
+std::shared_ptr<Texture> AssetCache::findTexture(const std::string& path, SDL_Renderer* renderer) {
+    return lookupTexture(textureKey(normalizePath(path), renderer));
+}
+
+std::shared_ptr<Font> AssetCache::findFont(const std::string& path, int size) {
+    return lookupFont(fontKey(normalizePath(path), size));
+}
+
+std::shared_ptr<Texture> AssetCache::addTexture(const std::string& path, SDL_Renderer* renderer,
+                                                SDL_Surface* surface, double decodeSeconds) {
+    std::string normalizedPath = normalizePath(path);
+    std::string key = textureKey(normalizedPath, renderer);
+    std::shared_ptr<Texture> texture = lookupTexture(key);
+    if (texture) return texture;
+    
+    ENGAIN_PROFILE_SCOPE("AssetCache::addTexture");
+    auto start = std::chrono::steady_clock::now();
+    misses++;
+    pruneExpired();
+    
+    texture = std::make_shared<Texture>();
+    if (!texture->loadFromSurface(surface, renderer)) {
+        ENGAIN_LOG_ERROR(ASSETS, "Unable to create texture from " << normalizedPath << "! SDL Error: " << SDL_GetError());
+        failures++;
+        return nullptr;
+    }
+    loadSeconds += decodeSeconds + secondsSince(start);
+    
+    textures[key] = Entry<Texture>{texture, textureBytes(*texture), 0};
+    return texture;
+}
+
+std::shared_ptr<Font> AssetCache::addFont(const std::string& path, int size,
+                                          std::shared_ptr<const std::vector<unsigned char>> data,
+                                          double readSeconds) {
+    std::string normalizedPath = normalizePath(path);
+    std::string key = fontKey(normalizedPath, size);
+    std::shared_ptr<Font> font = lookupFont(key);
+    if (font) return font;
+    
+    ENGAIN_PROFILE_SCOPE("AssetCache::addFont");
+    auto start = std::chrono::steady_clock::now();
+    misses++;
+    pruneExpired();
+    
+    data = getFontData(normalizedPath, std::move(data));
+    font = std::make_shared<Font>();
+    if (!data || !font->loadFromMemory(data, size, normalizedPath)) {
+        failures++;
+        return nullptr;
+    }
+    loadSeconds += readSeconds + secondsSince(start);
+    
+    // The file bytes are counted once, under their own entry
+    fonts[key] = Entry<Font>{font, 0, 0};
+    return font;
+}
+
+std::shared_ptr<const std::vector<unsigned char>> AssetCache::readFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        ENGAIN_LOG_ERROR(ASSETS, "Failed to open " << path);
+        return nullptr;
+    }
+    std::streamsize length = file.tellg();
+    file.seekg(0, std::ios::beg);
+    
+    auto data = std::make_shared<std::vector<unsigned char>>(static_cast<size_t>(std::max<std::streamsize>(length, 0)));
+    if (length <= 0 || !file.read(reinterpret_cast<char*>(data->data()), length)) {
+        ENGAIN_LOG_ERROR(ASSETS, "Failed to read " << path);
+        return nullptr;
+    }
+    return data;
+}
+
+std::shared_ptr<Texture> AssetCache::lookupTexture(const std::string& key) {
+    auto it = textures.find(key);
+    if (it == textures.end()) return nullptr;
+    
+    std::shared_ptr<Texture> texture = it->second.asset.lock();
+    if (!texture) return nullptr;
+    
+    it->second.hits++;
+    hits++;
+    return texture;
+}
+
+std::shared_ptr<Font> AssetCache::lookupFont(const std::string& key) {
+    auto it = fonts.find(key);
+    if (it == fonts.end()) return nullptr;
+    
+    std::shared_ptr<Font> font = it->second.asset.lock();
+    if (!font) return nullptr;
+    
+    it->second.hits++;
+    hits++;
+    return font;
+}
+
+std::shared_ptr<const std::vector<unsigned char>> AssetCache::getFontData(const std::string& normalizedPath,
+    std::shared_ptr<const std::vector<unsigned char>> data) {
+    auto it = fontData.find(normalizedPath);
+    if (it != fontData.end()) {
+        std::shared_ptr<const std::vector<unsigned char>> cached = it->second.asset.lock();
+        if (cached) {
+            it->second.hits++;
+            return cached;
+        }
+    }
+    
+    if (!data) {
+        data = readFile(normalizedPath);
+        if (!data) return nullptr;
+    }
+    fontData[normalizedPath] = Entry<const std::vector<unsigned char>>{data, data->size(), 0};
+    return data;
+}
+
+void AssetCache::pruneExpired() {
+    eraseExpired(textures);
+    eraseExpired(fonts);
+    eraseExpired(fontData);
+}
+
+std::vector<AssetCache::AssetInfo> AssetCache::getAssets() {
+    pruneExpired();
+    
+    std::vector<AssetInfo> assets;
+    collect(textures, AssetType::TEXTURE, assets);
+    collect(fonts, AssetType::FONT, assets);
+    collect(fontData, AssetType::FONT_DATA, assets);
+    std::sort(assets.begin(), assets.end(), [](const AssetInfo& a, const AssetInfo& b) {
+        return a.bytes > b.bytes;
+    });
+    return assets;
+}
+
+AssetCache::Stats AssetCache::getStats() {
+    Stats stats = {hits, misses, failures, loadSeconds, 0, 0};
+    for (const AssetInfo& asset : getAssets()) {
+        stats.liveAssets++;
+        stats.liveBytes += asset.bytes;
+    }
+    return stats;
+}
+
+void AssetCache::resetStats() {
+    hits = 0;
+    misses = 0;
+    failures = 0;
+    loadSeconds = 0.0;
+}
+
+void AssetCache::logReport() {
+    Stats stats = getStats();
+    uint64_t requests = stats.hits + stats.misses;
+    ENGAIN_LOG_INFO(ASSETS, "Asset cache: " << requests << " requests, " << stats.hits << " hits, "
+                    << stats.misses << " misses (" << stats.failures << " failed), "
+                    << stats.loadSeconds * 1000.0 << " ms loading, " << stats.liveAssets << " live assets, "
+                    << stats.liveBytes / 1024 << " KiB");
+    
+    for (const AssetInfo& asset : getAssets()) {
+        ENGAIN_LOG_INFO(ASSETS, "  " << typeName(asset.type) << " " << asset.key << ": "
+                        << asset.bytes / 1024 << " KiB, " << asset.handles << " handle(s), "
+                        << asset.hits << " hit(s)");
+    }
+}
+
+} // namespace ENGAIN
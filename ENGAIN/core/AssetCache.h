@@ -0,0 +1,109 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Texture.h"
+#include "Font.h"
+
+namespace ENGAIN {
+
+// Shares loaded textures and fonts between everything that asks for the same
+// file. Textures are keyed by normalized path and renderer, fonts by path and
+// point size; every size of one font file opens from a single copy of the
+// file in memory.
+//
+// The cache only holds weak references: an asset is freed as soon as the last
+// handle to it goes away, and the next request loads it again. Handles to
+// textures must be dropped before their renderer is destroyed. The cache
+// belongs to the main thread; AssetLoader decodes on workers and hands the
+// results in here.
+class AssetCache {
+public:
+    enum class AssetType {
+        TEXTURE,
+        FONT,
+        FONT_DATA
+    };
+    
+    struct AssetInfo {
+        std::string key;
+        AssetType type;
+        size_t bytes;       // Estimated; textures count 4 bytes per pixel
+        long handles;
+        uint64_t hits;
+    };
+    
+    struct Stats {
+        uint64_t hits;
+        uint64_t misses;
+        uint64_t failures;
+        double loadSeconds; // Spent on misses
+        size_t liveAssets;
+        size_t liveBytes;
+    };
+    
+    static AssetCache& getInstance();
+    
+    // Null if the file cannot be loaded; failures are not cached
+    std::shared_ptr<Texture> getTexture(const std::string& path, SDL_Renderer* renderer);
+    std::shared_ptr<Font> getFont(const std::string& path, int size);
+    
+    // A live handle, counted as a hit, or null without loading anything
+    std::shared_ptr<Texture> findTexture(const std::string& path, SDL_Renderer* renderer);
+    std::shared_ptr<Font> findFont(const std::string& path, int size);
+    // Finish a load whose file was read elsewhere; decodeSeconds is added to
+    // the load time. A handle already cached for the key wins.
+    std::shared_ptr<Texture> addTexture(const std::string& path, SDL_Renderer* renderer,
+                                        SDL_Surface* surface, double decodeSeconds = 0.0);
+    std::shared_ptr<Font> addFont(const std::string& path, int size,
+                                  std::shared_ptr<const std::vector<unsigned char>> data,
+                                  double readSeconds = 0.0);
+    
+    // Whole file, or null; safe to call from any thread
+    static std::shared_ptr<const std::vector<unsigned char>> readFile(const std::string& path);
+    
+    // Absolute, with "." and ".." resolved and symlinks followed where the
+    // file exists, so different spellings of one file share an entry
+    static std::string normalizePath(const std::string& path);
+    
+    // Assets that still have handles
+    std::vector<AssetInfo> getAssets();
+    Stats getStats();
+    void resetStats();
+    void logReport();
+
+private:
+    template<typename T>
+    struct Entry {
+        std::weak_ptr<T> asset;
+        size_t bytes;
+        uint64_t hits;
+    };
+    
+    AssetCache();
+    AssetCache(const AssetCache&) = delete;
+    AssetCache& operator=(const AssetCache&) = delete;
+    
+    std::shared_ptr<Texture> lookupTexture(const std::string& key);
+    std::shared_ptr<Font> lookupFont(const std::string& key);
+    // Cached bytes for the file, else data, else read from disk
+    std::shared_ptr<const std::vector<unsigned char>> getFontData(const std::string& normalizedPath,
+        std::shared_ptr<const std::vector<unsigned char>> data = nullptr);
+    void pruneExpired();
+    
+    std::unordered_map<std::string, Entry<Texture>> textures;
+    std::unordered_map<std::string, Entry<Font>> fonts;
+    std::unordered_map<std::string, Entry<const std::vector<unsigned char>>> fontData;
+    
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t failures;
+    double loadSeconds;
+};
+
+} // namespace ENGAIN
@@ -0,0 +1,337 @@
+#include "AssetLoader.h"
+#include "AssetCache.h"
+#include "Logger.h"
+#include "Profiler.h"
+#include <SDL2/SDL_image.h>
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
+namespace ENGAIN {
+
+namespace {
+    // Worker threads when the core count is unknown, and at most
+    const unsigned int DEFAULT_THREADS = 2;
+    const unsigned int MAX_THREADS = 8;
+    
+    double secondsSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    
+    template<typename T>
+    AsyncAsset<T> readyAsset(std::shared_ptr<T> value) {
+        std::promise<std::shared_ptr<T>> promise;
+        promise.set_value(std::move(value));
+        return AsyncAsset<T>(promise.get_future().share());
+    }
+    
+    std::shared_ptr<SDL_Surface> shareSurface(SDL_Surface* surface) {
+        if (!surface) return nullptr;
+        return std::shared_ptr<SDL_Surface>(surface, SDL_FreeSurface);
+    }
+}
+
+AssetLoader::AssetLoader()
+    : running(false),
+      threadCount(0),
+      stopping(false),
+      decodeSeconds(0.0),
+      pending(0),
+      requests(0),
+      cacheHits(0),
+      shared(0),
+      completed(0),
+      failed(0),
+      uploadSeconds(0.0),
+      maxUpdateMs(0.0) {
+}
+
+AssetLoader::~AssetLoader() {
+    stop();
+}
+
+bool AssetLoader::start(unsigned int threads) {
+    if (running) return true;
+    
+    if (threads == 0) {
+        unsigned int cores = std::thread::hardware_concurrency();
+        threads = cores > 1 ? std::min(cores - 1, MAX_THREADS) : DEFAULT_THREADS;
+    }
+    
+    // Load the codecs once here rather than racing to on the first decodes
+    IMG_Init(IMG_INIT_PNG | IMG_INIT_JPG);
+    
+    stopping = false;
+    threadCount = threads;
+    for (unsigned int i = 0; i < threads; i++) {
+        workers.emplace_back(&AssetLoader::workerLoop, this);
+    }
+    running = true;
+    
+    ENGAIN_LOG_INFO(ASSETS, "Asset loader started with " << threads << " worker thread(s)");
+    return true;
+}
+
+void AssetLoader::stop() {
+    if (!running) return;
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& worker : workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    workers.clear();
+    
+    for (const std::shared_ptr<Job>& job : queued) {
+        abandon(*job);
+    }
+    for (const std::shared_ptr<Job>& job : decoded) {
+        abandon(*job);
+    }
+    queued.clear();
+    decoded.clear();
+    inFlight.clear();
+    pending = 0;
+    running = false;
+}
+
+AsyncAsset<Texture> AssetLoader::loadTexture(const std::string& path, SDL_Renderer* renderer) {
+    requests++;
+    AssetCache& cache = AssetCache::getInstance();
+    std::shared_ptr<Texture> cached = cache.findTexture(path, renderer);
+    if (cached) {
+        cacheHits++;
+        return readyAsset(cached);
+    }
+    if (!running) {
+        return readyAsset(cache.getTexture(path, renderer));
+    }
+    
+    std::string normalized = AssetCache::normalizePath(path);
+    std::string key = "texture:" + normalized + ":" + std::to_string(reinterpret_cast<uintptr_t>(renderer));
+    auto it = inFlight.find(key);
+    if (it != inFlight.end()) {
+        shared++;
+        return AsyncAsset<Texture>(it->second->textureResult);
+    }
+    return AsyncAsset<Texture>(submit(JobType::TEXTURE, normalized, key, renderer, 0)->textureResult);
+}
+
+AsyncAsset<Font> AssetLoader::loadFont(const std::string& path, int size) {
+    requests++;
+    AssetCache& cache = AssetCache::getInstance();
+    std::shared_ptr<Font> cached = cache.findFont(path, size);
+    if (cached) {
+        cacheHits++;
+        return readyAsset(cached);
+    }
+    if (!running) {
+        return readyAsset(cache.getFont(path, size));
+    }
+    
+    std::string normalized = AssetCache::normalizePath(path);
+    std::string key = "font:" + normalized + ":" + std::to_string(size);
+    auto it = inFlight.find(key);
+    if (it != inFlight.end()) {
+        shared++;
+        return AsyncAsset<Font>(it->second->fontResult);
+    }
+    return AsyncAsset<Font>(submit(JobType::FONT, normalized, key, nullptr, size)->fontResult);
+}
+
+AsyncAsset<SDL_Surface> AssetLoader::loadSurface(const std::string& path) {
+    requests++;
+    std::string normalized = AssetCache::normalizePath(path);
+    if (!running) {
+        Job job;
+        job.type = JobType::SURFACE;
+        job.path = normalized;
+        job.surface = nullptr;
+        decode(job);
+        return readyAsset(shareSurface(job.surface));
+    }
+    
+    // Every caller gets its own surface, so these are never shared
+    std::string key = "surface:" + normalized + ":" + std::to_string(requests);
+    return AsyncAsset<SDL_Surface>(submit(JobType::SURFACE, normalized, key, nullptr, 0)->imageResult);
+}
+
+size_t AssetLoader::update(double budgetSeconds) {
+    if (pending == 0) return 0;
+    
+    ENGAIN_PROFILE_SCOPE("AssetLoader::update");
+    auto start = std::chrono::steady_clock::now();
+    size_t finished = 0;
+    while (true) {
+        std::shared_ptr<Job> job;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (decoded.empty()) break;
+            job = std::move(decoded.front());
+            decoded.pop_front();
+        }
+        
+        complete(*job);
+        finished++;
+        if (secondsSince(start) >= budgetSeconds) break;
+    }
+    
+    double seconds = secondsSince(start);
+    uploadSeconds += seconds;
+    maxUpdateMs = std::max(maxUpdateMs, seconds * 1000.0);
+    return finished;
+}
+
+void AssetLoader::finish() {
+    ENGAIN_PROFILE_SCOPE("AssetLoader::finish");
+    while (pending > 0) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            decodedReady.wait(lock, [this] { return !decoded.empty(); });
+        }
+        update(std::numeric_limits<double>::infinity());
+    }
+}
+
+AssetLoader::Stats AssetLoader::getStats() const {
+    Stats stats = {requests, cacheHits, shared, completed, failed, 0.0, uploadSeconds, maxUpdateMs};
+    std::lock_guard<std::mutex> lock(mutex);
+    stats.decodeSeconds = decodeSeconds;
+    return stats;
+}
+
+void AssetLoader::logReport() const {
+    Stats stats = getStats();
+    ENGAIN_LOG_INFO(ASSETS, "Asset loader: " << stats.requests << " requests, " << stats.cacheHits
+                    << " cache hits, " << stats.shared << " shared, " << stats.completed << " loaded, "
+                    << stats.failed << " failed; " << stats.decodeSeconds * 1000.0 << " ms decoding on "
+                    << threadCount << " worker(s), " << stats.uploadSeconds * 1000.0
+                    << " ms on the main thread, longest update " << stats.maxUpdateMs << " ms");
+}
+
+std::shared_ptr<AssetLoader::Job> AssetLoader::submit(JobType type, const std::string& path, const std::string& key,
+                                                      SDL_Renderer* renderer, int fontSize) {
+    std::shared_ptr<Job> job = std::make_shared<Job>();
+    job->type = type;
+    job->path = path;
+    job->key = key;
+    job->renderer = renderer;
+    job->fontSize = fontSize;
+    job->surface = nullptr;
+    job->decodeSeconds = 0.0;
+    job->textureResult = job->texture.get_future().share();
+    job->fontResult = job->font.get_future().share();
+    job->imageResult = job->image.get_future().share();
+    
+    inFlight[key] = job;
+    pending++;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        queued.push_back(job);
+    }
+    wake.notify_one();
+    return job;
+}
+
+void AssetLoader::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [this] { return stopping || !queued.empty(); });
+        // Queued jobs are dropped on stop
+        if (stopping) break;
+        
+        std::shared_ptr<Job> job = std::move(queued.front());
+        queued.pop_front();
+        
+        lock.unlock();
+        decode(*job);
+        lock.lock();
+        
+        decodeSeconds += job->decodeSeconds;
+        decoded.push_back(std::move(job));
+        decodedReady.notify_one();
+    }
+}
+
+void AssetLoader::decode(Job& job) {
+    ENGAIN_PROFILE_SCOPE("AssetLoader::decode");
+    auto start = std::chrono::steady_clock::now();
+    
+    if (job.type == JobType::FONT) {
+        // SDL_ttf is not thread-safe, so workers only read the file
+        job.fileData = AssetCache::readFile(job.path);
+    } else {
+        SDL_Surface* loadedSurface = IMG_Load(job.path.c_str());
+        if (!loadedSurface) {
+            ENGAIN_LOG_ERROR(ASSETS, "Unable to load image " << job.path << "! SDL_image Error: " << IMG_GetError());
+        } else {
+            // Converted here, the upload on the main thread is a plain copy
+            job.surface = SDL_ConvertSurfaceFormat(loadedSurface, SDL_PIXELFORMAT_ARGB8888, 0);
+            SDL_FreeSurface(loadedSurface);
+            if (!job.surface) {
+                ENGAIN_LOG_ERROR(ASSETS, "Unable to convert image " << job.path << "! SDL Error: " << SDL_GetError());
+            }
+        }
+    }
+    
+    job.decodeSeconds = secondsSince(start);
+}
+
+void AssetLoader::complete(Job& job) {
+    bool loaded = false;
+    switch (job.type) {
+        case JobType::TEXTURE: {
+            std::shared_ptr<Texture> texture;
+            if (job.surface) {
+                texture = AssetCache::getInstance().addTexture(job.path, job.renderer, job.surface, job.decodeSeconds);
+                SDL_FreeSurface(job.surface);
+                job.surface = nullptr;
+            }
+            loaded = texture != nullptr;
+            job.texture.set_value(std::move(texture));
+            break;
+        }
+        case JobType::FONT: {
+            std::shared_ptr<Font> font;
+            if (job.fileData) {
+                font = AssetCache::getInstance().addFont(job.path, job.fontSize, std::move(job.fileData),
+                                                         job.decodeSeconds);
+            }
+            loaded = font != nullptr;
+            job.font.set_value(std::move(font));
+            break;
+        }
+        case JobType::SURFACE:
+            loaded = job.surface != nullptr;
+            job.image.set_value(shareSurface(job.surface));
+            job.surface = nullptr;
+            break;
+    }
+    
+    if (loaded) {
+        completed++;
+    } else {
+        failed++;
+    }
+    inFlight.erase(job.key);
+    pending--;
+}
+
+void AssetLoader::abandon(Job& job) {
+    if (job.surface) {
+        SDL_FreeSurface(job.surface);
+        job.surface = nullptr;
+    }
+    switch (job.type) {
+        case JobType::TEXTURE: job.texture.set_value(nullptr); break;
+        case JobType::FONT: job.font.set_value(nullptr); break;
+        case JobType::SURFACE: job.image.set_value(nullptr); break;
+    }
+}
+
+} // namespace ENGAIN
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "Texture.h"
+#include "Font.h"
+
+namespace ENGAIN {
+
+// Result of an asynchronous load. It becomes ready during
+// AssetLoader::update() or finish() on the main thread, so waiting on the
+// future directly from the main thread never returns.
+template<typename T>
+class AsyncAsset {
+public:
+    AsyncAsset() = default;
+    explicit AsyncAsset(std::shared_future<std::shared_ptr<T>> future) : future(std::move(future)) {}
+    
+    bool isValid() const { return future.valid(); }
+    bool isReady() const {
+        return future.valid() && future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }
+    // Null until ready, and if loading failed
+    std::shared_ptr<T> get() const { return isReady() ? future.get() : nullptr; }
+    const std::shared_future<std::shared_ptr<T>>& getFuture() const { return future; }
+
+private:
+    std::shared_future<std::shared_ptr<T>> future;
+};
+
+// Decodes images and reads font files on a pool of worker threads. Anything
+// that touches the renderer or SDL_ttf stays on the main thread: update()
+// uploads decoded images and opens fonts until its time budget is spent, so
+// loading spreads over frames instead of stalling one. Finished textures and
+// fonts go into the AssetCache, and a request for something already cached or
+// already in flight shares the same result.
+class AssetLoader {
+public:
+    struct Stats {
+        uint64_t requests;
+        uint64_t cacheHits;      // Ready at once from the AssetCache
+        uint64_t shared;         // Joined a load already in flight
+        uint64_t completed;
+        uint64_t failed;
+        double decodeSeconds;    // Summed over workers
+        double uploadSeconds;    // Main thread
+        double maxUpdateMs;      // Longest single update()
+    };
+    
+    AssetLoader();
+    ~AssetLoader();
+    
+    // 0 threads uses one per core, leaving one for the main thread
+    bool start(unsigned int threads = 0);
+    // Loads not yet finished complete with null
+    void stop();
+    bool isRunning() const { return running; }
+    unsigned int getThreadCount() const { return threadCount; }
+    
+    AsyncAsset<Texture> loadTexture(const std::string& path, SDL_Renderer* renderer);
+    AsyncAsset<Font> loadFont(const std::string& path, int size);
+    // Decoded image in ARGB8888, for building atlases; not cached
+    AsyncAsset<SDL_Surface> loadSurface(const std::string& path);
+    
+    // Main thread, once per frame: finish decoded loads until budgetSeconds
+    // is used up, at least one per call. Returns the number finished.
+    size_t update(double budgetSeconds = 0.002);
+    // Main thread: block until every request so far is done, for loading screens
+    void finish();
+    size_t getPendingCount() const { return pending; }
+    
+    Stats getStats() const;
+    void logReport() const;
+
+private:
+    AssetLoader(const AssetLoader&) = delete;
+    AssetLoader& operator=(const AssetLoader&) = delete;
+    
+    enum class JobType {
+        TEXTURE,
+        FONT,
+        SURFACE
+    };
+    
+    struct Job {
+        JobType type;
+        std::string path;       // Normalized
+        std::string key;
+        SDL_Renderer* renderer;
+        int fontSize;
+        
+        // Filled in by the worker
+        SDL_Surface* surface;
+        std::shared_ptr<const std::vector<unsigned char>> fileData;
+        double decodeSeconds;
+        
+        std::promise<std::shared_ptr<Texture>> texture;
+        std::promise<std::shared_ptr<Font>> font;
+        std::promise<std::shared_ptr<SDL_Surface>> image;
+        std::shared_future<std::shared_ptr<Texture>> textureResult;
+        std::shared_future<std::shared_ptr<Font>> fontResult;
+        std::shared_future<std::shared_ptr<SDL_Surface>> imageResult;
+    };
+    
+    std::shared_ptr<Job> submit(JobType type, const std::string& path, const std::string& key,
+                                SDL_Renderer* renderer, int fontSize);
+    void workerLoop();
+    void decode(Job& job);
+    // Main thread: upload or open the result and fulfil the promise
+    void complete(Job& job);
+    void abandon(Job& job);
+    
+    bool running;
+    unsigned int threadCount;
+    std::vector<std::thread> workers;
+    
+    // Shared with the workers
+    mutable std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable decodedReady;
+    std::deque<std::shared_ptr<Job>> queued;
+    std::deque<std::shared_ptr<Job>> decoded;
+    bool stopping;
+    double decodeSeconds;
+    
+    // Main thread only
+    std::unordered_map<std::string, std::shared_ptr<Job>> inFlight;
+    size_t pending;
+    uint64_t requests;
+    uint64_t cacheHits;
+    uint64_t shared;
+    uint64_t completed;
+    uint64_t failed;
+    double uploadSeconds;
+    double maxUpdateMs;
+};
+
+} // namespace ENGAIN
@@ -0,0 +1,172 @@
+#include "BinaryLog.h"
+#include <chrono>
+#include <filesystem>
+
+namespace ENGAIN {
+
+namespace {
+    int64_t monotonicNanoseconds() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+    
+    int64_t wallClockNanoseconds() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+    
+    template <typename T>
+    void put(std::vector<char>& out, T value) {
+        const char* bytes = reinterpret_cast<const char*>(&value);
+        out.insert(out.end(), bytes, bytes + sizeof(T));
+    }
+}
+
+BinaryLog::BinaryLog() : opened(false), file(nullptr), bytesWritten(0) {}
+
+BinaryLog::~BinaryLog() {
+    close();
+}
+
+BinaryLog& BinaryLog::getInstance() {
+    static BinaryLog instance;
+    return instance;
+}
+
+std::mutex& BinaryLog::registryMutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+std::vector<BinaryLog::FormatEntry>& BinaryLog::registry() {
+    static std::vector<FormatEntry> entries;
+    return entries;
+}
+
+uint32_t BinaryLog::registerFormat(LogLevel level, const char* format) {
+    std::lock_guard<std::mutex> lock(registryMutex());
+    registry().push_back(FormatEntry{level, format});
+    return static_cast<uint32_t>(registry().size() - 1);
+}
+
+bool BinaryLog::open(const std::string& logDir) {
+    std::lock_guard<std::mutex> lock(writeMutex);
+    if (file) return true;
+    
+    std::filesystem::create_directories(logDir);
+    
+    std::time_t now = std::time(nullptr);
+    std::tm* localTime = std::localtime(&now);
+    
+    std::ostringstream filename;
+    filename << logDir << "/engain_"
+             << std::put_time(localTime, "%Y%m%d_%H%M%S")
+             << ".blog";
+    
+    file = std::fopen(filename.str().c_str(), "wb");
+    if (!file) {
+        Logger::getInstance().error("Failed to open binary log file: " + filename.str());
+        return false;
+    }
+    
+    buffer.clear();
+    buffer.reserve(BUFFER_SIZE);
+    formatWritten.clear();
+    
+    buffer.insert(buffer.end(), BinaryLogFormat::MAGIC, BinaryLogFormat::MAGIC + sizeof(BinaryLogFormat::MAGIC));
+    put<uint32_t>(buffer, BinaryLogFormat::VERSION);
+    put<int64_t>(buffer, wallClockNanoseconds());
+    put<int64_t>(buffer, monotonicNanoseconds());
+    
+    opened.store(true, std::memory_order_release);
+    Logger::getInstance().info("Binary log opened: " + filename.str());
+    return true;
+}
+
+void BinaryLog::close() {
+    std::lock_guard<std::mutex> lock(writeMutex);
+    if (!file) return;
+    
+    opened.store(false, std::memory_order_release);
+    flushBuffer();
+    std::fclose(file);
+    file = nullptr;
+}
+
+void BinaryLog::flush() {
+    std::lock_guard<std::mutex> lock(writeMutex);
+    if (!file) return;
+    
+    flushBuffer();
+    std::fflush(file);
+}
+
+void BinaryLog::append(uint32_t formatId, const char* payload, size_t length) {
+    int64_t timestamp = monotonicNanoseconds();
+    
+    std::lock_guard<std::mutex> lock(writeMutex);
+    if (!file) return;
+    
+    // Each file carries the definitions of the formats it uses
+    if (formatId >= formatWritten.size() || !formatWritten[formatId]) {
+        writeFormatRecord(formatId);
+    }
+    
+    buffer.push_back(static_cast<char>(BinaryLogFormat::MESSAGE_RECORD));
+    put<uint32_t>(buffer, formatId);
+    put<int64_t>(buffer, timestamp);
+    put<uint16_t>(buffer, static_cast<uint16_t>(length));
+    buffer.insert(buffer.end(), payload, payload + length);
+    
+    if (buffer.size() >= BUFFER_SIZE - MAX_PAYLOAD) {
+        flushBuffer();
+    }
+}
+
+void BinaryLog::writeFormatRecord(uint32_t formatId) {
+    FormatEntry entry;
+    {
+        std::lock_guard<std::mutex> lock(registryMutex());
+        if (formatId >= registry().size()) return;
+        entry = registry()[formatId];
+    }
+    
+    if (formatId >= formatWritten.size()) {
+        formatWritten.resize(formatId + 1, false);
+    }
+    formatWritten[formatId] = true;
+    
+    size_t length = entry.text.size() < 0xFFFF ? entry.text.size() : 0xFFFF;
+    
+    buffer.push_back(static_cast<char>(BinaryLogFormat::FORMAT_RECORD));
+    put<uint32_t>(buffer, formatId);
+    put<uint8_t>(buffer, static_cast<uint8_t>(entry.level));
+    put<uint16_t>(buffer, static_cast<uint16_t>(length));
+    buffer.insert(buffer.end(), entry.text.data(), entry.text.data() + length);
+}
+
+void BinaryLog::flushBuffer() {
+    if (buffer.empty()) return;
+    
+    std::fwrite(buffer.data(), 1, buffer.size(), file);
+    bytesWritten += buffer.size();
+    buffer.clear();
+}
+
+void BinaryLog::encodeString(char* payload, size_t& length, const char* text, size_t textLength) {
+    if (length + 1 + sizeof(uint16_t) > MAX_PAYLOAD) return;
+    
+    size_t available = MAX_PAYLOAD - length - 1 - sizeof(uint16_t);
+    if (textLength > available) {
+        textLength = available;
+    }
+    
+    uint16_t stored = static_cast<uint16_t>(textLength);
+    payload[length++] = static_cast<char>(BinaryLogFormat::ARG_STRING);
+    std::memcpy(payload + length, &stored, sizeof(stored));
+    length += sizeof(stored);
+    std::memcpy(payload + length, text, textLength);
+    length += textLength;
+}
+
+} // namespace ENGAIN
@@ -0,0 +1,201 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <sstream>
+#include <type_traits>
+#include "Logger.h"
+
+namespace ENGAIN {
+
+// On-disk layout, shared with the engain_logdecode tool. All values are
+// written in native byte order.
+//
+//   header:  magic[8] version:u32 wallClockNs:i64 monotonicNs:i64
+//   format:  FORMAT_RECORD id:u32 level:u8 length:u16 text[length]
+//   message: MESSAGE_RECORD id:u32 timestampNs:i64 length:u16 args[length]
+//
+// Each argument is a type tag followed by an int64, uint64 or double, or
+// a u16 length and the bytes of a string.
+namespace BinaryLogFormat {
+    const char MAGIC[8] = {'E', 'N', 'G', 'B', 'L', 'O', 'G', '1'};
+    const uint32_t VERSION = 1;
+    
+    enum RecordType : uint8_t {
+        FORMAT_RECORD = 1,
+        MESSAGE_RECORD = 2
+    };
+    
+    enum ArgType : uint8_t {
+        ARG_INT = 1,
+        ARG_UINT = 2,
+        ARG_DOUBLE = 3,
+        ARG_STRING = 4
+    };
+}
+
+// Binary log sink. Call sites register their "{}" format string once and
+// then only write its id, a monotonic timestamp and the raw argument bytes.
+class BinaryLog {
+public:
+    static BinaryLog& getInstance();
+    
+    bool open(const std::string& logDir = "logs");
+    void close();
+    void flush();
+    
+    bool isOpen() const { return opened.load(std::memory_order_acquire); }
+    unsigned long long getBytesWritten() const { return bytesWritten; }
+    
+    static uint32_t registerFormat(LogLevel level, const char* format);
+    
+    template <typename... Args>
+    void write(uint32_t formatId, const char* format, const Args&... args) {
+        (void)format;
+        char payload[MAX_PAYLOAD];
+        size_t length = 0;
+        (encode(payload, length, args), ...);
+        append(formatId, payload, length);
+    }
+    
+    // Text rendering of a format string, matching what engain_logdecode prints
+    template <typename... Args>
+    static std::string formatText(const char* format, const Args&... args) {
+        std::ostringstream out;
+        const char* cursor = format;
+        (appendArg(out, cursor, args), ...);
+        out << cursor;
+        return out.str();
+    }
+    
+    ~BinaryLog();
+
+private:
+    BinaryLog();
+    BinaryLog(const BinaryLog&) = delete;
+    BinaryLog& operator=(const BinaryLog&) = delete;
+    
+    static const size_t MAX_PAYLOAD = 1024;
+    static const size_t BUFFER_SIZE = 64 * 1024;
+    
+    struct FormatEntry {
+        LogLevel level;
+        std::string text;
+    };
+    
+    static std::mutex& registryMutex();
+    static std::vector<FormatEntry>& registry();
+    
+    void append(uint32_t formatId, const char* payload, size_t length);
+    void writeFormatRecord(uint32_t formatId);
+    void flushBuffer();
+    
+    template <typename T>
+    static void encode(char* payload, size_t& length, const T& value) {
+        using Type = typename std::decay<T>::type;
+        
+        if constexpr (std::is_same<Type, bool>::value) {
+            encodeValue(payload, length, BinaryLogFormat::ARG_INT, static_cast<int64_t>(value ? 1 : 0));
+        } else if constexpr (std::is_same<Type, char>::value) {
+            encodeString(payload, length, &value, 1);
+        } else if constexpr (std::is_integral<Type>::value && std::is_signed<Type>::value) {
+            encodeValue(payload, length, BinaryLogFormat::ARG_INT, static_cast<int64_t>(value));
+        } else if constexpr (std::is_integral<Type>::value) {
+            encodeValue(payload, length, BinaryLogFormat::ARG_UINT, static_cast<uint64_t>(value));
+        } else if constexpr (std::is_floating_point<Type>::value) {
+            encodeValue(payload, length, BinaryLogFormat::ARG_DOUBLE, static_cast<double>(value));
+        } else if constexpr (std::is_same<Type, std::string>::value) {
+            encodeString(payload, length, value.data(), value.size());
+        } else {
+            static_assert(std::is_convertible<Type, const char*>::value,
+                          "Unsupported binary log argument type");
+            const char* text = value;
+            if (!text) text = "(null)";
+            encodeString(payload, length, text, std::strlen(text));
+        }
+    }
+    
+    template <typename T>
+    static void encodeValue(char* payload, size_t& length, uint8_t type, T value) {
+        if (length + 1 + sizeof(T) > MAX_PAYLOAD) return;
+        payload[length++] = static_cast<char>(type);
+        std::memcpy(payload + length, &value, sizeof(T));
+        length += sizeof(T);
+    }
+    
+    static void encodeString(char* payload, size_t& length, const char* text, size_t textLength);
+    
+    template <typename T>
+    static void appendArg(std::ostringstream& out, const char*& cursor, const T& value) {
+        const char* placeholder = std::strstr(cursor, "{}");
+        if (!placeholder) return;
+        out.write(cursor, placeholder - cursor);
+        out << value;
+        cursor = placeholder + 2;
+    }
+    
+    std::mutex writeMutex;
+    std::atomic<bool> opened;
+    std::FILE* file;
+    std::vector<char> buffer;
+    std::vector<bool> formatWritten;
+    unsigned long long bytesWritten;
+};
+
+} // namespace ENGAIN
+
+// Format-string logging, e.g. ENGAIN_LOGF_DEBUG(WINDOW, "Resized to {}x{}", w, h).
+// Goes to the binary log when it is open and to the text log otherwise.
+#define ENGAIN_LOGF_FORMAT_(...) ENGAIN_LOGF_FORMAT_IMPL_(__VA_ARGS__, unused)
+#define ENGAIN_LOGF_FORMAT_IMPL_(format, ...) format
+
+#define ENGAIN_LOGF(level, channel, ...) \
+    do { \
+        ::ENGAIN::Logger& engainLogger_ = ::ENGAIN::Logger::getInstance(); \
+        if (engainLogger_.isEnabled(level, ::ENGAIN::LogChannel::channel)) { \
+            static const uint32_t engainFormatId_ = \
+                ::ENGAIN::BinaryLog::registerFormat(level, ENGAIN_LOGF_FORMAT_(__VA_ARGS__)); \
+            ::ENGAIN::BinaryLog& engainBinaryLog_ = ::ENGAIN::BinaryLog::getInstance(); \
+            if (engainBinaryLog_.isOpen()) { \
+                engainBinaryLog_.write(engainFormatId_, __VA_ARGS__); \
+            } else { \
+                engainLogger_.log(level, ::ENGAIN::LogChannel::channel, \
+                                  ::ENGAIN::BinaryLog::formatText(__VA_ARGS__)); \
+            } \
+        } \
+    } while (0)
+
+#if ENGAIN_MIN_LOG_LEVEL <= 0
+#define ENGAIN_LOGF_DEBUG(channel, ...) ENGAIN_LOGF(::ENGAIN::LogLevel::DEBUG, channel, __VA_ARGS__)
+#else
+#define ENGAIN_LOGF_DEBUG(channel, ...) do {} while (0)
+#endif
+
+#if ENGAIN_MIN_LOG_LEVEL <= 1
+#define ENGAIN_LOGF_INFO(channel, ...) ENGAIN_LOGF(::ENGAIN::LogLevel::INFO, channel, __VA_ARGS__)
+#else
+#define ENGAIN_LOGF_INFO(channel, ...) do {} while (0)
+#endif
+
+#if ENGAIN_MIN_LOG_LEVEL <= 2
+#define ENGAIN_LOGF_WARNING(channel, ...) ENGAIN_LOGF(::ENGAIN::LogLevel::WARNING, channel, __VA_ARGS__)
+#else
+#define ENGAIN_LOGF_WARNING(channel, ...) do {} while (0)
+#endif
+
+#if ENGAIN_MIN_LOG_LEVEL <= 3
+#define ENGAIN_LOGF_ERROR(channel, ...) ENGAIN_LOGF(::ENGAIN::LogLevel::ERROR, channel, __VA_ARGS__)
+#else
+#define ENGAIN_LOGF_ERROR(channel, ...) do {} while (0)
+#endif
+
+#if ENGAIN_MIN_LOG_LEVEL <= 4
+#define ENGAIN_LOGF_CRITICAL(channel, ...) ENGAIN_LOGF(::ENGAIN::LogLevel::CRITICAL, channel, __VA_ARGS__)
+#else
+#define ENGAIN_LOGF_CRITICAL(channel, ...) do {} while (0)
+#endif
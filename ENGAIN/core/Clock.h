@@ -0,0 +1,47 @@
+#pragma once
+
+#include <chrono>
+
+namespace ENGAIN {
+
+// Time source behind TimeManager
+class Clock {
+public:
+    using TimePoint = std::chrono::steady_clock::time_point;
+    using Duration = std::chrono::steady_clock::duration;
+    
+    virtual ~Clock() {}
+    
+    virtual TimePoint now() const = 0;
+    // Called once per TimeManager::update() before now() is read
+    virtual void tick() {}
+    // Virtual clocks do not follow real time, so there is nothing to wait for
+    virtual bool isVirtual() const { return false; }
+};
+
+// Real time from std::chrono::steady_clock
+class SystemClock : public Clock {
+public:
+    TimePoint now() const override { return std::chrono::steady_clock::now(); }
+};
+
+// Advances by exactly one frame per tick, independent of real time, so every
+// run sees identical deltas and can go as fast as the CPU allows
+class VirtualClock : public Clock {
+public:
+    explicit VirtualClock(float frameTime)
+        : current(),
+          step(std::chrono::duration_cast<Duration>(std::chrono::duration<double>(frameTime))) {}
+    
+    TimePoint now() const override { return current; }
+    void tick() override { current += step; }
+    bool isVirtual() const override { return true; }
+    
+    Duration getStep() const { return step; }
+
+private:
+    TimePoint current;
+    Duration step;
+};
+
+} // namespace ENGAIN
@@ -0,0 +1,109 @@
+#include "DirtyRegion.h"
+#include <algorithm>
+
+namespace ENGAIN {
+
+namespace {
+    // Merge two rectangles when their bounding box wastes at most this much
+    // area over the two alone; fewer, larger rectangles mean fewer passes
+    const float MERGE_WASTE = 1.25f;
+    
+    long long area(const SDL_Rect& rect) {
+        return static_cast<long long>(rect.w) * rect.h;
+    }
+    
+    SDL_Rect unite(const SDL_Rect& a, const SDL_Rect& b) {
+        int left = std::min(a.x, b.x);
+        int top = std::min(a.y, b.y);
+        int right = std::max(a.x + a.w, b.x + b.w);
+        int bottom = std::max(a.y + a.h, b.y + b.h);
+        return SDL_Rect{left, top, right - left, bottom - top};
+    }
+    
+    bool overlaps(const SDL_Rect& a, const SDL_Rect& b) {
+        return a.x < b.x + b.w && b.x < a.x + a.w && a.y < b.y + b.h && b.y < a.y + a.h;
+    }
+}
+
+DirtyRegion::DirtyRegion(int width, int height, float fullRedrawCoverage, size_t maxRects)
+    : width(width),
+      height(height),
+      fullRedrawCoverage(fullRedrawCoverage),
+      maxRects(maxRects),
+      full(false) {
+}
+
+void DirtyRegion::setBounds(int newWidth, int newHeight) {
+    width = newWidth;
+    height = newHeight;
+    addAll();
+}
+
+void DirtyRegion::add(const SDL_Rect& rect) {
+    if (full) return;
+    
+    // Clip to the screen
+    int left = std::max(rect.x, 0);
+    int top = std::max(rect.y, 0);
+    int right = std::min(rect.x + rect.w, width);
+    int bottom = std::min(rect.y + rect.h, height);
+    if (right <= left || bottom <= top) return;
+    
+    rects.push_back(SDL_Rect{left, top, right - left, bottom - top});
+    mergeFrom(rects.size() - 1);
+    
+    if (rects.size() > maxRects || getCoverage() >= fullRedrawCoverage) {
+        addAll();
+    }
+}
+
+void DirtyRegion::addAll() {
+    rects.clear();
+    if (width > 0 && height > 0) {
+        rects.push_back(SDL_Rect{0, 0, width, height});
+    }
+    full = true;
+}
+
+void DirtyRegion::clear() {
+    rects.clear();
+    full = false;
+}
+
+float DirtyRegion::getCoverage() const {
+    if (width <= 0 || height <= 0) return 0.0f;
+    
+    // Merged rectangles may still overlap a little, so this can overestimate
+    long long dirty = 0;
+    for (const SDL_Rect& rect : rects) {
+        dirty += area(rect);
+    }
+    return std::min(1.0f, static_cast<float>(dirty) / (static_cast<float>(width) * height));
+}
+
+void DirtyRegion::mergeFrom(size_t index) {
+    // A merge grows the rectangle, which can make it touch others again
+    bool merged = true;
+    while (merged) {
+        merged = false;
+        for (size_t i = 0; i < rects.size(); i++) {
+            if (i == index) continue;
+            
+            SDL_Rect combined = unite(rects[index], rects[i]);
+            if (overlaps(rects[index], rects[i]) ||
+                area(combined) <= (area(rects[index]) + area(rects[i])) * MERGE_WASTE) {
+                rects[index] = combined;
+                rects[i] = rects.back();
+                rects.pop_back();
+                // The merged rectangle may have been the one moved into slot i
+                if (index == rects.size()) {
+                    index = i;
+                }
+                merged = true;
+                break;
+            }
+        }
+    }
+}
+
+} // namespace ENGAIN
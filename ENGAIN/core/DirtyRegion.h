@@ -0,0 +1,40 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <vector>
+
+namespace ENGAIN {
+
+// The parts of the screen that changed this frame, as a few merged
+// rectangles. Once they cover enough of the screen, or there are too many
+// of them, the region turns into a single full-screen rectangle because one
+// full redraw is then cheaper than many partial ones.
+class DirtyRegion {
+public:
+    DirtyRegion(int width = 0, int height = 0, float fullRedrawCoverage = 0.6f, size_t maxRects = 16);
+    
+    void setBounds(int width, int height);
+    
+    // Clipped to the bounds and merged with the rectangles it touches
+    void add(const SDL_Rect& rect);
+    void addAll();
+    void clear();
+    
+    bool isEmpty() const { return rects.empty(); }
+    bool isFull() const { return full; }
+    const std::vector<SDL_Rect>& getRects() const { return rects; }
+    // Fraction of the bounds that is dirty
+    float getCoverage() const;
+
+private:
+    void mergeFrom(size_t index);
+    
+    int width;
+    int height;
+    float fullRedrawCoverage;
+    size_t maxRects;
+    bool full;
+    std::vector<SDL_Rect> rects;
+};
+
+} // namespace ENGAIN
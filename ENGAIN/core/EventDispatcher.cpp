@@ -0,0 +1,186 @@
+#include "EventDispatcher.h"
+#include "Logger.h"
+#include "Profiler.h"
+#include <algorithm>
+
+namespace ENGAIN {
+
+namespace {
+    // Enough for a busy frame without growing
+    const size_t INITIAL_EVENT_CAPACITY = 256;
+}
+
+EventDispatcher::EventDispatcher()
+    : nextId(1),
+      frameNumber(0),
+      dispatching(false),
+      filterInstalled(false),
+      filteredCount(0) {
+    for (std::atomic<uint32_t>& bits : wantedTypes) {
+        bits.store(0, std::memory_order_relaxed);
+    }
+    frameEvents.reserve(INITIAL_EVENT_CAPACITY);
+}
+
+EventDispatcher::~EventDispatcher() {
+}
+
+EventDispatcher& EventDispatcher::getInstance() {
+    static EventDispatcher instance;
+    return instance;
+}
+
+void EventDispatcher::initialize() {
+    if (filterInstalled) return;
+    
+    // Also drops whatever is already queued that nobody wants
+    SDL_SetEventFilter(&EventDispatcher::filterEvent, this);
+    filterInstalled = true;
+    ENGAIN_LOG_DEBUG(INPUT, "Event dispatcher ready, " << listeners.size() << " event types subscribed");
+}
+
+void EventDispatcher::shutdown() {
+    if (!filterInstalled) return;
+    
+    SDL_SetEventFilter(nullptr, nullptr);
+    filterInstalled = false;
+    ENGAIN_LOG_DEBUG(INPUT, "Event dispatcher filtered " << getFilteredCount() << " unwanted events");
+}
+
+EventListenerId EventDispatcher::subscribe(Uint32 type, Listener listener) {
+    if (type >= TYPE_COUNT || !listener) return 0;
+    
+    Subscription subscription{nextId++, type, std::move(listener)};
+    EventListenerId id = subscription.id;
+    setWanted(type, true);
+    
+    // Adding now could reallocate the list being iterated
+    if (dispatching) {
+        pendingSubscriptions.push_back(std::move(subscription));
+    } else {
+        addSubscription(std::move(subscription));
+    }
+    return id;
+}
+
+void EventDispatcher::unsubscribe(EventListenerId id) {
+    if (id == 0) return;
+    
+    for (auto it = pendingSubscriptions.begin(); it != pendingSubscriptions.end(); ++it) {
+        if (it->id == id) {
+            Uint32 type = it->type;
+            pendingSubscriptions.erase(it);
+            setWanted(type, hasListeners(type));
+            return;
+        }
+    }
+    
+    for (auto& entry : listeners) {
+        for (Subscription& subscription : entry.second) {
+            if (subscription.id != id) continue;
+            
+            if (dispatching) {
+                // Skipped for the rest of this pump, erased afterwards
+                subscription.id = 0;
+                pendingRemovals.push_back(entry.first);
+            } else {
+                removeSubscription(entry.first, id);
+            }
+            return;
+        }
+    }
+}
+
+bool EventDispatcher::hasListeners(Uint32 type) const {
+    auto found = listeners.find(type);
+    if (found != listeners.end()) {
+        for (const Subscription& subscription : found->second) {
+            if (subscription.id != 0) return true;
+        }
+    }
+    for (const Subscription& subscription : pendingSubscriptions) {
+        if (subscription.type == type) return true;
+    }
+    return false;
+}
+
+void EventDispatcher::pump() {
+    ENGAIN_PROFILE_SCOPE("EventDispatcher::pump");
+    frameNumber++;
+    
+    frameEvents.clear();
+    SDL_Event event;
+    while (SDL_PollEvent(&event)) {
+        frameEvents.push_back(event);
+    }
+    
+    dispatching = true;
+    for (const SDL_Event& frameEvent : frameEvents) {
+        auto found = listeners.find(frameEvent.type);
+        if (found == listeners.end()) continue;
+        
+        const std::vector<Subscription>& subscriptions = found->second;
+        for (size_t i = 0; i < subscriptions.size(); i++) {
+            if (subscriptions[i].id != 0) {
+                subscriptions[i].listener(frameEvent);
+            }
+        }
+    }
+    dispatching = false;
+    
+    for (Uint32 type : pendingRemovals) {
+        removeSubscription(type, 0);
+    }
+    pendingRemovals.clear();
+    for (Subscription& subscription : pendingSubscriptions) {
+        addSubscription(std::move(subscription));
+    }
+    pendingSubscriptions.clear();
+}
+
+int EventDispatcher::filterEvent(void* userData, SDL_Event* event) {
+    EventDispatcher* dispatcher = static_cast<EventDispatcher*>(userData);
+    if (dispatcher->isWanted(event->type)) {
+        return 1;
+    }
+    dispatcher->filteredCount.fetch_add(1, std::memory_order_relaxed);
+    return 0;
+}
+
+void EventDispatcher::setWanted(Uint32 type, bool wanted) {
+    if (type >= TYPE_COUNT) return;
+    
+    uint32_t bit = 1u << (type % 32);
+    if (wanted) {
+        wantedTypes[type / 32].fetch_or(bit, std::memory_order_relaxed);
+    } else {
+        wantedTypes[type / 32].fetch_and(~bit, std::memory_order_relaxed);
+    }
+}
+
+bool EventDispatcher::isWanted(Uint32 type) const {
+    return type < TYPE_COUNT &&
+           (wantedTypes[type / 32].load(std::memory_order_relaxed) & (1u << (type % 32))) != 0;
+}
+
+void EventDispatcher::addSubscription(Subscription&& subscription) {
+    listeners[subscription.type].push_back(std::move(subscription));
+}
+
+void EventDispatcher::removeSubscription(Uint32 type, EventListenerId id) {
+    auto found = listeners.find(type);
+    if (found == listeners.end()) return;
+    
+    std::vector<Subscription>& subscriptions = found->second;
+    subscriptions.erase(std::remove_if(subscriptions.begin(), subscriptions.end(),
+                                       [id](const Subscription& subscription) {
+                                           return subscription.id == id;
+                                       }),
+                        subscriptions.end());
+    if (subscriptions.empty()) {
+        listeners.erase(found);
+    }
+    setWanted(type, hasListeners(type));
+}
+
+} // namespace ENGAIN
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace ENGAIN {
+
+// Identifies a subscription; 0 never refers to one
+using EventListenerId = uint32_t;
+
+// Drains the SDL queue once per frame into a reused array and hands each
+// event to the listeners subscribed to its type, so window, input and game
+// code share one pass over the events. Types nobody listens to are dropped
+// by an SDL event filter before they are queued, which keeps floods such as
+// mouse motion from costing anything.
+class EventDispatcher {
+public:
+    using Listener = std::function<void(const SDL_Event&)>;
+    
+    static EventDispatcher& getInstance();
+    
+    // Install the event filter; SDL must be initialized
+    void initialize();
+    // Remove the filter before SDL shuts down; subscriptions are kept
+    void shutdown();
+    
+    // Listeners may subscribe and unsubscribe while events are dispatched;
+    // new listeners start with the next pump()
+    EventListenerId subscribe(Uint32 type, Listener listener);
+    void unsubscribe(EventListenerId id);
+    bool hasListeners(Uint32 type) const;
+    
+    // Poll every pending event, then dispatch them in order
+    void pump();
+    
+    // Events collected by the last pump()
+    const std::vector<SDL_Event>& getFrameEvents() const { return frameEvents; }
+    // Counts pump() calls, starting at 1 for the first
+    uint64_t getFrameNumber() const { return frameNumber; }
+    // Events the filter dropped since initialize()
+    uint64_t getFilteredCount() const { return filteredCount.load(std::memory_order_relaxed); }
+
+private:
+    EventDispatcher();
+    ~EventDispatcher();
+    EventDispatcher(const EventDispatcher&) = delete;
+    EventDispatcher& operator=(const EventDispatcher&) = delete;
+    
+    struct Subscription {
+        EventListenerId id;     // 0 once unsubscribed during dispatch
+        Uint32 type;
+        Listener listener;
+    };
+    
+    // Runs on whichever thread pushes the event
+    static int filterEvent(void* userData, SDL_Event* event);
+    void setWanted(Uint32 type, bool wanted);
+    bool isWanted(Uint32 type) const;
+    void addSubscription(Subscription&& subscription);
+    void removeSubscription(Uint32 type, EventListenerId id);
+    
+    static constexpr size_t TYPE_COUNT = SDL_LASTEVENT + 1;
+    
+    std::unordered_map<Uint32, std::vector<Subscription>> listeners;
+    std::vector<Subscription> pendingSubscriptions;
+    // Types with listeners unsubscribed during dispatch
+    std::vector<Uint32> pendingRemovals;
+    // One bit per event type with a listener, read by the filter
+    std::atomic<uint32_t> wantedTypes[TYPE_COUNT / 32];
+    
+    std::vector<SDL_Event> frameEvents;
+    EventListenerId nextId;
+    uint64_t frameNumber;
+    bool dispatching;
+    bool filterInstalled;
+    std::atomic<uint64_t> filteredCount;
+};
+
+} // namespace ENGAIN
@@ -0,0 +1,219 @@
+#include "FlightRecorder.h"
+#include "Logger.h"
+#include "LogThrottle.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <filesystem>
+
+namespace ENGAIN {
+
+FlightRecorder& FlightRecorder::getInstance() {
+    static FlightRecorder instance;
+    return instance;
+}
+
+FlightRecorder::FlightRecorder()
+    : enabled(false),
+      ownsProfiler(false),
+      cursor(0),
+      lastFrameEnd(0),
+      lastReportTime(0),
+      reportCount(0),
+      hitchCount(0) {
+    // Construct these first so they are still alive when the recorder is destroyed
+    Profiler::getInstance();
+    Logger::getInstance();
+}
+
+FlightRecorder::~FlightRecorder() {
+    shutdown();
+}
+
+void FlightRecorder::initialize() {
+    FlightRecorderConfig settings;
+    
+    if (const char* value = std::getenv("ENGAIN_FLIGHT_RECORDER")) {
+        std::string option = value;
+        if (option == "0") return;
+        if (!option.empty() && option != "1") {
+            settings.outputDir = option;
+        }
+    }
+    
+    if (const char* hitch = std::getenv("ENGAIN_HITCH_MS")) {
+        float milliseconds = std::strtof(hitch, nullptr);
+        if (milliseconds > 0.0f) {
+            settings.thresholdSeconds = milliseconds / 1000.0f;
+        }
+    }
+    
+    enable(settings);
+}
+
+void FlightRecorder::enable(const FlightRecorderConfig& newConfig) {
+    disable();
+    
+    config = newConfig;
+    frames.assign(std::max<size_t>(config.frameHistory, 1), FrameRecord{0, 0, 0});
+    cursor = 0;
+    lastFrameEnd = 0;
+    lastReportTime = 0;
+    events.reserve(config.eventsPerThread);
+    
+    // Reuse a session that is already running, otherwise keep a rolling one
+    Profiler& profiler = Profiler::getInstance();
+    if (!Profiler::isRecording()) {
+        profiler.setMaxEventsPerThread(config.eventsPerThread);
+        profiler.startContinuous();
+        ownsProfiler = true;
+    }
+    
+    Logger::getInstance().setRecentLogCapacity(config.logBytes);
+    enabled = true;
+    
+    if (config.thresholdSeconds > 0.0f) {
+        ENGAIN_LOG_INFO(TIME, "Flight recorder enabled, hitch threshold "
+                        << config.thresholdSeconds * 1000.0f << " ms, reports in " << config.outputDir);
+    } else {
+        ENGAIN_LOG_INFO(TIME, "Flight recorder enabled, hitch threshold "
+                        << config.thresholdFactor << "x target frame time, reports in " << config.outputDir);
+    }
+}
+
+void FlightRecorder::disable() {
+    if (!enabled) return;
+    enabled = false;
+    
+    if (ownsProfiler) {
+        Profiler::getInstance().stop();
+        ownsProfiler = false;
+    }
+    Logger::getInstance().setRecentLogCapacity(0);
+    
+    if (hitchCount > 0) {
+        ENGAIN_LOG_INFO(TIME, "Flight recorder saw " << hitchCount << " hitches, wrote "
+                        << reportCount << " reports");
+    }
+}
+
+void FlightRecorder::shutdown() {
+    disable();
+}
+
+void FlightRecorder::onHitch(const FrameRecord& frame, float targetFrameTime) {
+    hitchCount++;
+    
+    double milliseconds = (frame.end - frame.start) / 1e6;
+    ENGAIN_LOG_THROTTLED(LogLevel::WARNING, TIME, 5, 10.0f,
+                         "Hitch: frame " << frame.frameNumber << " took " << milliseconds << " ms");
+    
+    int64_t cooldown = static_cast<int64_t>(config.cooldownSeconds * 1e9f);
+    if (lastReportTime != 0 && frame.end - lastReportTime < cooldown) return;
+    if (config.maxReports > 0 && reportCount >= static_cast<unsigned int>(config.maxReports)) return;
+    
+    char reason[128];
+    std::snprintf(reason, sizeof(reason), "frame %u took %.2f ms (threshold %.2f ms, target %.2f ms)",
+                  frame.frameNumber, milliseconds, thresholdFor(targetFrameTime) / 1e6,
+                  targetFrameTime * 1000.0f);
+    dump(reason);
+    
+    // Writing the report is slow too; start the cooldown after it, and keep
+    // that time out of the next frame so it is not reported as a hitch
+    lastReportTime = Profiler::now();
+    lastFrameEnd = lastReportTime;
+}
+
+bool FlightRecorder::dump(const std::string& reason) {
+    if (frames.empty() || cursor == 0) return false;
+    
+    size_t history = frames.size();
+    uint64_t first = cursor > history ? cursor - history : 0;
+    int64_t windowStart = frames[first % history].start;
+    if (windowStart == 0) windowStart = frames[first % history].end;
+    
+    events.clear();
+    Profiler::getInstance().collectEvents(windowStart, events);
+    std::sort(events.begin(), events.end(), [](const ProfileEvent& a, const ProfileEvent& b) {
+        if (a.threadIndex != b.threadIndex) return a.threadIndex < b.threadIndex;
+        if (a.start != b.start) return a.start < b.start;
+        return a.duration > b.duration;
+    });
+    
+    // Lines still queued for the async writer are part of the story
+    Logger& logger = Logger::getInstance();
+    if (logger.isAsync()) {
+        logger.flush();
+    }
+    std::string recentLog = logger.getRecentLog();
+    
+    std::error_code error;
+    std::filesystem::create_directories(config.outputDir, error);
+    
+    std::time_t now = std::time(nullptr);
+    std::tm localTime;
+#ifdef _WIN32
+    localtime_s(&localTime, &now);
+#else
+    localtime_r(&now, &localTime);
+#endif
+    char stamp[32];
+    std::strftime(stamp, sizeof(stamp), "%Y%m%d_%H%M%S", &localTime);
+    
+    const FrameRecord& last = frames[(cursor - 1) % history];
+    std::string path = config.outputDir + "/hitch_" + stamp + "_frame" +
+                       std::to_string(last.frameNumber) + ".txt";
+    
+    FILE* file = std::fopen(path.c_str(), "w");
+    if (!file) {
+        ENGAIN_LOG_ERROR(TIME, "Failed to write hitch report: " << path);
+        return false;
+    }
+    
+    std::fprintf(file, "Hitch report: %s\n", reason.c_str());
+    std::fprintf(file, "Times are in milliseconds from the start of the oldest frame\n\n");
+    
+    std::fprintf(file, "Frames (%llu):\n", static_cast<unsigned long long>(cursor - first));
+    std::fprintf(file, "%10s %10s %10s\n", "frame", "start", "duration");
+    for (uint64_t i = first; i < cursor; i++) {
+        const FrameRecord& record = frames[i % history];
+        int64_t start = record.start != 0 ? record.start : record.end;
+        std::fprintf(file, "%10u %10.3f %10.3f%s\n", record.frameNumber,
+                     (start - windowStart) / 1e6, (record.end - start) / 1e6,
+                     i + 1 == cursor ? "  <--" : "");
+    }
+    
+    // Scopes per thread, indented by nesting depth
+    std::fprintf(file, "\nScopes (%zu, dropped %llu):\n", events.size(),
+                 static_cast<unsigned long long>(Profiler::getInstance().getDroppedCount()));
+    std::vector<int64_t> openScopes;
+    unsigned int currentThread = 0;
+    for (size_t i = 0; i < events.size(); i++) {
+        const ProfileEvent& event = events[i];
+        if (i == 0 || event.threadIndex != currentThread) {
+            currentThread = event.threadIndex;
+            openScopes.clear();
+            std::string name = Profiler::getInstance().getThreadName(currentThread);
+            std::fprintf(file, "  thread %u%s%s\n", currentThread,
+                         name.empty() ? "" : " ", name.c_str());
+        }
+        
+        int64_t end = event.start + event.duration;
+        while (!openScopes.empty() && openScopes.back() <= event.start) {
+            openScopes.pop_back();
+        }
+        std::fprintf(file, "%*s%10.3f %9.3f  %s\n", static_cast<int>(openScopes.size() * 2 + 4), "",
+                     (event.start - windowStart) / 1e6, event.duration / 1e6, event.name);
+        openScopes.push_back(end);
+    }
+    
+    std::fprintf(file, "\nRecent log:\n%s", recentLog.c_str());
+    std::fclose(file);
+    
+    reportCount++;
+    ENGAIN_LOG_WARNING(TIME, "Hitch report written to " << path << ": " << reason);
+    return true;
+}
+
+} // namespace ENGAIN
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Profiler.h"
+
+namespace ENGAIN {
+
+struct FlightRecorderConfig {
+    size_t frameHistory;      // Frames kept and written to each report
+    float thresholdFactor;    // A hitch is a frame longer than this many target frame times
+    float thresholdSeconds;   // Fixed hitch threshold, used instead of the factor when > 0
+    float cooldownSeconds;    // Minimum time between two reports
+    int maxReports;           // Reports written per run, 0 for no limit
+    size_t eventsPerThread;   // Profiler ring size when the recorder starts the profiler
+    size_t logBytes;          // Recent log output kept for reports
+    std::string outputDir;
+    
+    FlightRecorderConfig(size_t frameHistory = 120, float thresholdFactor = 2.0f,
+                         float thresholdSeconds = 0.0f, float cooldownSeconds = 5.0f,
+                         int maxReports = 20, const std::string& outputDir = "logs/hitches")
+        : frameHistory(frameHistory), thresholdFactor(thresholdFactor),
+          thresholdSeconds(thresholdSeconds), cooldownSeconds(cooldownSeconds),
+          maxReports(maxReports), eventsPerThread(16384), logBytes(16 * 1024),
+          outputDir(outputDir) {}
+};
+
+// Keeps the timing of the last few frames and, through the profiler's
+// continuous mode, the scopes that ran in them. When a frame takes longer
+// than the threshold the window is written to outputDir together with the
+// recent log output. A normal frame costs one clock read and a store.
+// Driven from TimeManager::update(), so it belongs to the game thread.
+class FlightRecorder {
+public:
+    static FlightRecorder& getInstance();
+    
+    // Enables the recorder unless ENGAIN_FLIGHT_RECORDER is "0". Any other
+    // value is used as the output directory; ENGAIN_HITCH_MS sets a fixed
+    // threshold in milliseconds.
+    void initialize();
+    void enable(const FlightRecorderConfig& config = FlightRecorderConfig());
+    void disable();
+    void shutdown();
+    
+    bool isEnabled() const { return enabled; }
+    const FlightRecorderConfig& getConfig() const { return config; }
+    
+    // Called once per frame with the frame's target duration in seconds
+    void recordFrame(unsigned int frameNumber, float targetFrameTime) {
+        int64_t end = Profiler::now();
+        FrameRecord& record = frames[cursor % frames.size()];
+        record.frameNumber = frameNumber;
+        record.start = lastFrameEnd;
+        record.end = end;
+        cursor++;
+        lastFrameEnd = end;
+        
+        // The first frame spans startup loading, so it is never a hitch
+        if (cursor > 1 && end - record.start > thresholdFor(targetFrameTime)) {
+            onHitch(record, targetFrameTime);
+        }
+    }
+    
+    // Write a report of the recorded window right away
+    bool dump(const std::string& reason);
+    
+    unsigned int getReportCount() const { return reportCount; }
+    unsigned int getHitchCount() const { return hitchCount; }
+
+private:
+    FlightRecorder();
+    ~FlightRecorder();
+    FlightRecorder(const FlightRecorder&) = delete;
+    FlightRecorder& operator=(const FlightRecorder&) = delete;
+    
+    struct FrameRecord {
+        unsigned int frameNumber;
+        int64_t start;   // Profiler clock, nanoseconds
+        int64_t end;
+    };
+    
+    int64_t thresholdFor(float targetFrameTime) const {
+        float seconds = config.thresholdSeconds > 0.0f ? config.thresholdSeconds
+                                                       : config.thresholdFactor * targetFrameTime;
+        // Sub-millisecond frames are all timer noise, never worth a report
+        return static_cast<int64_t>(std::max(seconds, MIN_THRESHOLD) * 1e9f);
+    }
+    
+    void onHitch(const FrameRecord& frame, float targetFrameTime);
+    
+    static constexpr float MIN_THRESHOLD = 0.001f;
+    
+    FlightRecorderConfig config;
+    bool enabled;
+    bool ownsProfiler;
+    
+    // Ring of recent frames; frame n lives at n % history size
+    std::vector<FrameRecord> frames;
+    uint64_t cursor;
+    int64_t lastFrameEnd;
+    
+    int64_t lastReportTime;
+    unsigned int reportCount;
+    unsigned int hitchCount;
+    
+    std::vector<ProfileEvent> events;
+};
+
+} // namespace ENGAIN
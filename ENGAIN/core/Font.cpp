@@ -1,5 +1,10 @@
 #include "Font.h"
+#include "AssetCache.h"
 #include "Logger.h"
+#include "BinaryLog.h"
+#include "LogThrottle.h"
+#include "Profiler.h"
+#include "PerfCounters.h"
 
 namespace ENGAIN {
 
@@ -11,16 +16,37 @@ Font::~Font() {
 }
 
 bool Font::loadFromFile(const std::string& path, int size) {
+    ENGAIN_PROFILE_SCOPE("Font::loadFromFile");
     free();
     
     font = TTF_OpenFont(path.c_str(), size);
     if (!font) {
-        Logger::getInstance().error("Failed to load font " + path + "! SDL_ttf Error: " + TTF_GetError());
+        ENGAIN_LOG_ERROR(ASSETS, "Failed to load font " << path << "! SDL_ttf Error: " << TTF_GetError());
         return false;
     }
     
     fontSize = size;
-    Logger::getInstance().info("Loaded font: " + path + " (size: " + std::to_string(size) + ")");
+    ENGAIN_LOGF_INFO(ASSETS, "Loaded font: {} (size: {})", path, size);
+    return true;
+}
+
+bool Font::loadFromMemory(std::shared_ptr<const std::vector<unsigned char>> data, int size,
+                          const std::string& name) {
+    ENGAIN_PROFILE_SCOPE("Font::loadFromMemory");
+    free();
+    if (!data || data->empty()) return false;
+    
+    // SDL_ttf reads glyphs from the stream for as long as the font is open
+    SDL_RWops* stream = SDL_RWFromConstMem(data->data(), static_cast<int>(data->size()));
+    font = stream ? TTF_OpenFontRW(stream, 1, size) : nullptr;
+    if (!font) {
+        ENGAIN_LOG_ERROR(ASSETS, "Failed to load font " << name << "! SDL_ttf Error: " << TTF_GetError());
+        return false;
+    }
+    
+    fontData = std::move(data);
+    fontSize = size;
+    ENGAIN_LOGF_INFO(ASSETS, "Loaded font: {} (size: {})", name, size);
     return true;
 }
 
@@ -29,6 +55,7 @@ void Font::free() {
         TTF_CloseFont(font);
         font = nullptr;
     }
+    fontData.reset();
 }
 
 SDL_Texture* Font::renderText(SDL_Renderer* renderer, const std::string& text, SDL_Color color) {
@@ -36,7 +63,7 @@ SDL_Texture* Font::renderText(SDL_Renderer* renderer, const std::string& text, S
     
     SDL_Surface* surface = TTF_RenderText_Blended(font, text.c_str(), color);
     if (!surface) {
-        Logger::getInstance().error("Failed to render text! SDL_ttf Error: " + std::string(TTF_GetError()));
+        ENGAIN_LOG_ERROR(RENDER, "Failed to render text! SDL_ttf Error: " << TTF_GetError());
         return nullptr;
     }
     
@@ -47,6 +74,7 @@ SDL_Texture* Font::renderText(SDL_Renderer* renderer, const std::string& text, S
 }
 
 void Font::drawText(SDL_Renderer* renderer, const std::string& text, int x, int y, SDL_Color color) {
+    ENGAIN_PROFILE_SCOPE("Font::drawText");
     SDL_Texture* texture = renderText(renderer, text, color);
     if (!texture) return;
     
@@ -89,39 +117,34 @@ bool TextRenderer::initialize() {
     if (initialized) return true;
     
     if (TTF_Init() == -1) {
-        Logger::getInstance().error("SDL_ttf could not initialize! SDL_ttf Error: " + std::string(TTF_GetError()));
+        ENGAIN_LOG_ERROR(RENDER, "SDL_ttf could not initialize! SDL_ttf Error: " << TTF_GetError());
         return false;
     }
     
-    Logger::getInstance().info("SDL_ttf initialized");
+    ENGAIN_LOG_INFO(RENDER, "SDL_ttf initialized");
     initialized = true;
     return true;
 }
 
 void TextRenderer::shutdown() {
-    for (auto& pair : fonts) {
-        delete pair.second;
-    }
+    // Fonts still held elsewhere must be gone before TTF_Quit
     fonts.clear();
     
     if (initialized) {
         TTF_Quit();
         initialized = false;
-        Logger::getInstance().info("SDL_ttf shutdown");
+        ENGAIN_LOG_INFO(RENDER, "SDL_ttf shutdown");
     }
 }
 
 bool TextRenderer::loadFont(const std::string& name, const std::string& path, int size) {
     if (!initialized) {
-        Logger::getInstance().error("TextRenderer not initialized!");
+        ENGAIN_LOG_ERROR(RENDER, "TextRenderer not initialized!");
         return false;
     }
     
-    Font* font = new Font();
-    if (!font->loadFromFile(path, size)) {
-        delete font;
-        return false;
-    }
+    std::shared_ptr<Font> font = AssetCache::getInstance().getFont(path, size);
+    if (!font) return false;
     
     fonts[name] = font;
     return true;
@@ -129,9 +152,10 @@ bool TextRenderer::loadFont(const std::string& name, const std::string& path, in
 
 void TextRenderer::drawText(SDL_Renderer* renderer, const std::string& text, int x, int y,
                            const std::string& fontName, SDL_Color color) {
+    ENGAIN_PERF_SCOPE("TextRenderer::drawText");
     auto it = fonts.find(fontName);
     if (it == fonts.end()) {
-        Logger::getInstance().warning("Font not found: " + fontName);
+        ENGAIN_LOG_THROTTLED(LogLevel::WARNING, RENDER, 3, 5.0f, "Font not found: " << fontName);
         return;
     }
     
@@ -2,8 +2,10 @@
 
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_ttf.h>
+#include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 #include "Window.h"
 
 namespace ENGAIN {
@@ -14,6 +16,10 @@ public:
     ~Font();
     
     bool loadFromFile(const std::string& path, int size);
+    // Open from a file already in memory; the font keeps data alive, so
+    // several sizes can share one copy. name is only used for logging.
+    bool loadFromMemory(std::shared_ptr<const std::vector<unsigned char>> data, int size,
+                        const std::string& name);
     void free();
     
     SDL_Texture* renderText(SDL_Renderer* renderer, const std::string& text, SDL_Color color);
@@ -25,6 +31,7 @@ public:
 private:
     TTF_Font* font;
     int fontSize;
+    std::shared_ptr<const std::vector<unsigned char>> fontData;
 };
 
 class TextRenderer {
@@ -34,6 +41,8 @@ public:
     bool initialize();
     void shutdown();
     
+    // Fonts come from the AssetCache, so loading a file again, or the same
+    // file at another size, does not read it twice
     bool loadFont(const std::string& name, const std::string& path, int size);
     void drawText(SDL_Renderer* renderer, const std::string& text, int x, int y, 
                   const std::string& fontName = "default", SDL_Color color = {255, 255, 255, 255});
@@ -45,7 +54,7 @@ private:
     TextRenderer& operator=(const TextRenderer&) = delete;
     
     bool initialized;
-    std::unordered_map<std::string, Font*> fonts;
+    std::unordered_map<std::string, std::shared_ptr<Font>> fonts;
 };
 
 } // namespace ENGAIN
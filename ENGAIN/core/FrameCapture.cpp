@@ -0,0 +1,239 @@
+#include "FrameCapture.h"
+#include "Logger.h"
+#include "Profiler.h"
+#include <SDL2/SDL_image.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <filesystem>
+#include <iomanip>
+
+namespace ENGAIN {
+
+namespace {
+    // 32 bits per pixel with the alpha byte ignored, so PNGs come out opaque
+    // whatever the back buffer's alpha holds
+    const Uint32 CAPTURE_FORMAT = SDL_PIXELFORMAT_RGB888;
+}
+
+FrameCapture::FrameCapture(const FrameCaptureConfig& config)
+    : config(config),
+      running(false),
+      frameNumber(0),
+      screenshotRequested(false),
+      stopping(false),
+      written(0),
+      failed(0),
+      captured(0),
+      dropped(0),
+      totalReadbackMs(0.0),
+      maxReadbackMs(0.0),
+      readbackFailed(false) {
+}
+
+FrameCapture::~FrameCapture() {
+    stop();
+}
+
+bool FrameCapture::start() {
+    if (running) return true;
+    
+    std::error_code error;
+    std::filesystem::create_directories(config.outputDir, error);
+    if (error) {
+        ENGAIN_LOG_ERROR(RENDER, "Cannot create capture directory " << config.outputDir << ": " << error.message());
+        return false;
+    }
+    
+    buffers.clear();
+    freeBuffers.clear();
+    readyBuffers.clear();
+    for (size_t i = 0; i < std::max<size_t>(config.bufferCount, 1); i++) {
+        buffers.emplace_back(new Buffer());
+        freeBuffers.push_back(buffers.back().get());
+    }
+    
+    stopping = false;
+    encoder = std::thread(&FrameCapture::encoderLoop, this);
+    running = true;
+    
+    if (config.frameInterval > 0) {
+        ENGAIN_LOG_INFO(RENDER, "Recording every " << config.frameInterval << " frame(s) to " << config.outputDir
+                        << " (" << buffers.size() << " buffers)");
+    }
+    return true;
+}
+
+void FrameCapture::stop() {
+    if (!running) return;
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    if (encoder.joinable()) {
+        encoder.join();
+    }
+    running = false;
+    
+    Stats stats = getStats();
+    ENGAIN_LOG_INFO(RENDER, "Frame capture stopped: " << stats.captured << " captured, " << stats.written
+                    << " written, " << stats.dropped << " dropped, " << stats.failed << " failed; readback "
+                    << std::fixed << std::setprecision(3) << stats.averageReadbackMs << " ms average, " << stats.maxReadbackMs << " ms max per frame");
+}
+
+void FrameCapture::requestScreenshot(const std::string& path) {
+    if (!start()) return;
+    screenshotPath = path;
+    screenshotRequested = true;
+}
+
+void FrameCapture::onFrame(SDL_Renderer* renderer) {
+    if (!running || !renderer) return;
+    ENGAIN_PROFILE_SCOPE("FrameCapture::onFrame");
+    
+    frameNumber++;
+    
+    // A screenshot waits for a free buffer rather than being dropped
+    if (screenshotRequested && capture(renderer, "screenshot", screenshotPath, CaptureFormat::PNG)) {
+        screenshotRequested = false;
+    }
+    
+    if (config.frameInterval > 0 && frameNumber % config.frameInterval == 0) {
+        capture(renderer, "frame", "", config.format);
+    }
+}
+
+FrameCapture::Stats FrameCapture::getStats() const {
+    Stats stats;
+    stats.captured = captured;
+    stats.dropped = dropped;
+    stats.averageReadbackMs = captured > 0 ? totalReadbackMs / captured : 0.0;
+    stats.maxReadbackMs = maxReadbackMs;
+    
+    std::lock_guard<std::mutex> lock(mutex);
+    stats.written = written;
+    stats.failed = failed;
+    return stats;
+}
+
+bool FrameCapture::capture(SDL_Renderer* renderer, const char* prefix, const std::string& path, CaptureFormat format) {
+    Buffer* buffer = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!freeBuffers.empty()) {
+            buffer = freeBuffers.back();
+            freeBuffers.pop_back();
+        }
+    }
+    
+    // The encoder is behind; never block the frame on it
+    if (!buffer) {
+        dropped++;
+        return false;
+    }
+    
+    auto start = std::chrono::steady_clock::now();
+    
+    int width = 0;
+    int height = 0;
+    SDL_GetRendererOutputSize(renderer, &width, &height);
+    buffer->width = width;
+    buffer->height = height;
+    buffer->pitch = width * 4;
+    buffer->pixels.resize(static_cast<size_t>(buffer->pitch) * height);
+    
+    if (width <= 0 || height <= 0 ||
+        SDL_RenderReadPixels(renderer, nullptr, CAPTURE_FORMAT, buffer->pixels.data(), buffer->pitch) != 0) {
+        if (!readbackFailed) {
+            ENGAIN_LOG_WARNING(RENDER, "Frame readback failed: " << SDL_GetError());
+            readbackFailed = true;
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        freeBuffers.push_back(buffer);
+        failed++;
+        return false;
+    }
+    
+    double readbackMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    totalReadbackMs += readbackMs;
+    maxReadbackMs = std::max(maxReadbackMs, readbackMs);
+    captured++;
+    
+    buffer->format = format;
+    buffer->path = !path.empty() ? path : makePath(prefix, format, width, height);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        readyBuffers.push_back(buffer);
+    }
+    wake.notify_one();
+    return true;
+}
+
+std::string FrameCapture::makePath(const char* prefix, CaptureFormat format, int width, int height) const {
+    char name[64];
+    std::snprintf(name, sizeof(name), "%s_%06llu", prefix, static_cast<unsigned long long>(frameNumber));
+    std::string path = config.outputDir + "/" + name;
+    if (format == CaptureFormat::RAW) {
+        return path + "_" + std::to_string(width) + "x" + std::to_string(height) + ".xrgb";
+    }
+    return path + ".png";
+}
+
+void FrameCapture::encoderLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [this] { return stopping || !readyBuffers.empty(); });
+        // Drain everything before stopping
+        if (readyBuffers.empty()) break;
+        
+        Buffer* buffer = readyBuffers.front();
+        readyBuffers.pop_front();
+        
+        lock.unlock();
+        bool ok = encode(*buffer);
+        lock.lock();
+        
+        if (ok) {
+            written++;
+        } else {
+            failed++;
+        }
+        freeBuffers.push_back(buffer);
+    }
+}
+
+bool FrameCapture::encode(const Buffer& buffer) {
+    if (buffer.format == CaptureFormat::RAW) {
+        FILE* file = std::fopen(buffer.path.c_str(), "wb");
+        bool ok = file && std::fwrite(buffer.pixels.data(), 1, buffer.pixels.size(), file) == buffer.pixels.size();
+        if (file) {
+            ok = std::fclose(file) == 0 && ok;
+        }
+        if (!ok) {
+            ENGAIN_LOG_ERROR(RENDER, "Failed to write " << buffer.path);
+        }
+        return ok;
+    }
+    
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormatFrom(const_cast<uint8_t*>(buffer.pixels.data()),
+                                                              buffer.width, buffer.height, 32,
+                                                              buffer.pitch, CAPTURE_FORMAT);
+    if (!surface) {
+        ENGAIN_LOG_ERROR(RENDER, "Failed to wrap captured frame: " << SDL_GetError());
+        return false;
+    }
+    bool ok = IMG_SavePNG(surface, buffer.path.c_str()) == 0;
+    SDL_FreeSurface(surface);
+    
+    if (!ok) {
+        ENGAIN_LOG_ERROR(RENDER, "Failed to write " << buffer.path << ": " << IMG_GetError());
+    } else {
+        ENGAIN_LOG_DEBUG(RENDER, "Captured " << buffer.path);
+    }
+    return ok;
+}
+
+} // namespace ENGAIN
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ENGAIN {
+
+enum class CaptureFormat {
+    PNG,
+    RAW     // XRGB8888 rows as read back, size in the file name
+};
+
+struct FrameCaptureConfig {
+    std::string outputDir;
+    CaptureFormat format;
+    // Record every Nth presented frame, 0 to only take screenshots
+    unsigned int frameInterval;
+    // Frames that can be waiting for the encoder before new ones are dropped
+    size_t bufferCount;
+    
+    FrameCaptureConfig(const std::string& outputDir = "captures",
+                       CaptureFormat format = CaptureFormat::PNG,
+                       unsigned int frameInterval = 0,
+                       size_t bufferCount = 4)
+        : outputDir(outputDir), format(format), frameInterval(frameInterval), bufferCount(bufferCount) {}
+};
+
+// Records presented frames to disk. The main thread only reads the frame
+// back into a pooled buffer; encoding and writing happen on a worker thread.
+// When every buffer is still queued for the encoder, frames are dropped
+// instead of stalling the game.
+class FrameCapture {
+public:
+    struct Stats {
+        uint64_t captured;
+        uint64_t dropped;
+        uint64_t written;
+        uint64_t failed;
+        double averageReadbackMs;   // Main thread cost per captured frame
+        double maxReadbackMs;
+    };
+    
+    explicit FrameCapture(const FrameCaptureConfig& config = FrameCaptureConfig());
+    ~FrameCapture();
+    
+    bool start();
+    // Waits for queued frames to be written
+    void stop();
+    bool isRunning() const { return running; }
+    
+    // Capture the next presented frame; an empty path picks a name in the output directory
+    void requestScreenshot(const std::string& path = "");
+    
+    // Called by Window before each present, while the back buffer is valid
+    void onFrame(SDL_Renderer* renderer);
+    
+    Stats getStats() const;
+    const FrameCaptureConfig& getConfig() const { return config; }
+
+private:
+    FrameCapture(const FrameCapture&) = delete;
+    FrameCapture& operator=(const FrameCapture&) = delete;
+    
+    struct Buffer {
+        std::vector<uint8_t> pixels;
+        int width;
+        int height;
+        int pitch;
+        std::string path;
+        CaptureFormat format;
+    };
+    
+    // Read the frame into a free buffer and queue it; the path defaults to
+    // prefix and frame number in the output directory
+    bool capture(SDL_Renderer* renderer, const char* prefix, const std::string& path, CaptureFormat format);
+    std::string makePath(const char* prefix, CaptureFormat format, int width, int height) const;
+    void encoderLoop();
+    bool encode(const Buffer& buffer);
+    
+    FrameCaptureConfig config;
+    bool running;
+    uint64_t frameNumber;
+    std::string screenshotPath;
+    bool screenshotRequested;
+    
+    std::vector<std::unique_ptr<Buffer>> buffers;
+    
+    // Shared with the encoder thread
+    mutable std::mutex mutex;
+    std::condition_variable wake;
+    std::vector<Buffer*> freeBuffers;
+    std::deque<Buffer*> readyBuffers;
+    bool stopping;
+    uint64_t written;
+    uint64_t failed;
+    std::thread encoder;
+    
+    // Main thread only
+    uint64_t captured;
+    uint64_t dropped;
+    double totalReadbackMs;
+    double maxReadbackMs;
+    bool readbackFailed;
+};
+
+} // namespace ENGAIN
@@ -0,0 +1,166 @@
+#include "FrameLatency.h"
+#include "Logger.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <thread>
+
+namespace ENGAIN {
+
+namespace {
+    // Smallest distance kept from the predicted vblank, and how much a
+    // missed vblank adds to it
+    const std::chrono::microseconds MIN_MARGIN(1000);
+    const std::chrono::microseconds MISS_PENALTY(500);
+    // Taken off the margin per on-time frame, so a one-off miss fades
+    const std::chrono::microseconds MARGIN_DECAY(10);
+    // Wake this early from the sleep and yield the rest
+    const std::chrono::microseconds SLEEP_SLACK(500);
+    // Frames of work measured before the first wait is attempted
+    const size_t MIN_WORK_SAMPLES = 30;
+    // SDL event timestamps are whole milliseconds; younger events count as
+    // arriving at the pump
+    const Uint32 TICK_RESOLUTION_MS = 1;
+    
+    double toSeconds(std::chrono::steady_clock::duration duration) {
+        return std::chrono::duration<double>(duration).count();
+    }
+}
+
+FrameLatency::FrameLatency()
+    : lowLatency(false),
+      refreshPeriod(Duration::zero()),
+      safetyMargin(MIN_MARGIN),
+      hasPresented(false),
+      frameStarted(false),
+      hasInput(false),
+      waitedThisFrame(false),
+      latencyStats(600, 2.0f / 60.0f),
+      workStats(600, 1.0f / 60.0f),
+      totalWait(0.0),
+      waitedFrames(0),
+      missedPresents(0) {
+}
+
+void FrameLatency::setRefreshPeriod(double seconds) {
+    refreshPeriod = seconds > 0.0
+        ? std::chrono::duration_cast<Duration>(std::chrono::duration<double>(seconds))
+        : Duration::zero();
+    if (seconds > 0.0) {
+        // Input shown within two refreshes is on budget
+        latencyStats.setBudget(static_cast<float>(seconds * 2.0));
+        workStats.setBudget(static_cast<float>(seconds));
+    }
+}
+
+void FrameLatency::setLowLatency(bool enabled) {
+    lowLatency = enabled;
+    safetyMargin = MIN_MARGIN;
+}
+
+void FrameLatency::waitForFrameStart() {
+    ENGAIN_PROFILE_SCOPE("FrameLatency::waitForFrameStart");
+    TimePoint now = std::chrono::steady_clock::now();
+    
+    if (lowLatency && hasPresented && refreshPeriod > Duration::zero() &&
+        workStats.getSampleCount() >= MIN_WORK_SAMPLES) {
+        // Present returns right after the vblank it waited for
+        Duration work = std::chrono::duration_cast<Duration>(
+            std::chrono::duration<double>(workStats.getPercentile(95.0f)));
+        TimePoint target = lastPresent + refreshPeriod - work - safetyMargin;
+        
+        // Already late: start now rather than aim for a later vblank
+        if (target > now) {
+            if (target - now > SLEEP_SLACK) {
+                std::this_thread::sleep_until(target - SLEEP_SLACK);
+            }
+            while (std::chrono::steady_clock::now() < target) {
+                std::this_thread::yield();
+            }
+            TimePoint woke = std::chrono::steady_clock::now();
+            totalWait += toSeconds(woke - now);
+            now = woke;
+            waitedThisFrame = true;
+        }
+        waitedFrames++;
+    }
+    
+    frameStart = now;
+    frameStarted = true;
+}
+
+void FrameLatency::onEventsPumped(TimePoint pumpTime, const std::vector<SDL_Event>& events) {
+    Uint32 ticks = SDL_GetTicks();
+    for (const SDL_Event& event : events) {
+        if (!isInputEvent(event.type)) continue;
+        
+        // Events SDL queued from another thread can be older than the pump
+        Uint32 ageMs = ticks - event.common.timestamp;
+        TimePoint arrival = pumpTime;
+        if (ageMs > TICK_RESOLUTION_MS && ageMs < 1000) {
+            arrival -= std::chrono::milliseconds(ageMs);
+        }
+        
+        if (!hasInput || arrival < oldestInput) {
+            oldestInput = arrival;
+            hasInput = true;
+        }
+    }
+}
+
+void FrameLatency::onPresentStart(TimePoint now) {
+    if (frameStarted) {
+        workStats.addSample(static_cast<float>(toSeconds(now - frameStart)));
+        frameStarted = false;
+    }
+}
+
+void FrameLatency::onPresented(TimePoint now) {
+    if (hasInput) {
+        latencyStats.addSample(static_cast<float>(toSeconds(now - oldestInput)));
+        hasInput = false;
+    }
+    
+    if (hasPresented && waitedThisFrame) {
+        // A waited frame that took more than a refresh and a half to show
+        // started too late for its vblank
+        if (now - lastPresent > refreshPeriod + refreshPeriod / 2) {
+            missedPresents++;
+            safetyMargin = std::min<Duration>(safetyMargin + MISS_PENALTY, refreshPeriod / 2);
+        } else if (safetyMargin > MIN_MARGIN) {
+            safetyMargin = std::max<Duration>(safetyMargin - MARGIN_DECAY, MIN_MARGIN);
+        }
+    }
+    
+    lastPresent = now;
+    hasPresented = true;
+    waitedThisFrame = false;
+}
+
+double FrameLatency::getRefreshPeriod() const {
+    return toSeconds(refreshPeriod);
+}
+
+double FrameLatency::getAverageWait() const {
+    return waitedFrames > 0 ? totalWait / waitedFrames : 0.0;
+}
+
+void FrameLatency::logReport() const {
+    const FrameStats::Summary& latency = latencyStats.getSummary();
+    ENGAIN_LOG_INFO(RENDER, "Input-to-present latency over " << latency.sampleCount << " frames: p50 "
+                    << latency.p50 * 1000.0f << " ms, p95 " << latency.p95 * 1000.0f << " ms, p99 "
+                    << latency.p99 * 1000.0f << " ms, max " << latency.max * 1000.0f << " ms");
+    
+    if (lowLatency) {
+        ENGAIN_LOG_INFO(RENDER, "Low-latency mode: " << getAverageWait() * 1000.0 << " ms average wait, "
+                        << workStats.getPercentile(95.0f) * 1000.0f << " ms p95 frame work, "
+                        << missedPresents << " missed vblanks, margin "
+                        << toSeconds(safetyMargin) * 1000.0 << " ms");
+    }
+}
+
+bool FrameLatency::isInputEvent(Uint32 type) {
+    // Keyboard, mouse, joystick, controller, touch and gesture events
+    return type >= SDL_KEYDOWN && type < SDL_CLIPBOARDUPDATE;
+}
+
+} // namespace ENGAIN
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+#include "FrameStats.h"
+
+namespace ENGAIN {
+
+// Input-to-present latency and, optionally, frame start pacing against the
+// display. Window feeds it the events each pump delivered and the moment
+// every present returned.
+//
+// Latency runs from the oldest input event of a frame reaching the engine
+// to the present that shows the frame. Time the event spent queued in the
+// OS before SDL saw it is not visible here.
+//
+// Low-latency mode waits before pumping events until the latest start that
+// still makes the next vblank, judged from the last present and the 95th
+// percentile of recent frame work, so input is sampled as late as possible.
+// A missed vblank widens the safety margin again.
+class FrameLatency {
+public:
+    using TimePoint = std::chrono::steady_clock::time_point;
+    using Duration = std::chrono::steady_clock::duration;
+    
+    FrameLatency();
+    
+    // Display refresh interval in seconds; 0 leaves low-latency waits off
+    void setRefreshPeriod(double seconds);
+    void setLowLatency(bool enabled);
+    bool isLowLatency() const { return lowLatency; }
+    
+    // Sleep until the predicted frame start; returns at once when low-latency
+    // mode is off or nothing has been presented yet
+    void waitForFrameStart();
+    // Events the pump at pumpTime delivered
+    void onEventsPumped(TimePoint pumpTime, const std::vector<SDL_Event>& events);
+    // Right before and right after the present call
+    void onPresentStart(TimePoint now);
+    void onPresented(TimePoint now);
+    
+    // Input-to-present latency, in seconds, over frames that had input
+    const FrameStats& getLatencyStats() const { return latencyStats; }
+    // Pump-to-present work of each frame, in seconds
+    const FrameStats& getWorkStats() const { return workStats; }
+    double getRefreshPeriod() const;
+    // Average low-latency wait per frame, in seconds
+    double getAverageWait() const;
+    uint64_t getMissedPresents() const { return missedPresents; }
+    
+    // Log latency percentiles and the low-latency wait
+    void logReport() const;
+
+private:
+    static bool isInputEvent(Uint32 type);
+    
+    bool lowLatency;
+    Duration refreshPeriod;
+    // Kept clear of the predicted vblank; grows on misses, decays otherwise
+    Duration safetyMargin;
+    
+    TimePoint frameStart;
+    TimePoint lastPresent;
+    TimePoint oldestInput;
+    bool hasPresented;
+    bool frameStarted;
+    bool hasInput;
+    bool waitedThisFrame;
+    
+    FrameStats latencyStats;
+    FrameStats workStats;
+    double totalWait;
+    uint64_t waitedFrames;
+    uint64_t missedPresents;
+};
+
+} // namespace ENGAIN
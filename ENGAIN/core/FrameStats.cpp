@@ -0,0 +1,209 @@
+#include "FrameStats.h"
+#include <algorithm>
+#include <cmath>
+
+namespace ENGAIN {
+
+FrameStats::FrameStats(size_t windowSize, float budget)
+    : budget(budget),
+      samples(windowSize > 0 ? windowSize : 1, 0.0f),
+      count(0),
+      histogram(BIN_COUNT, 0),
+      overflowSum(0.0),
+      sum(0.0),
+      sumSquares(0.0),
+      overBudgetInWindow(0),
+      overBudgetTotal(0),
+      maxQueue(samples.size(), 0),
+      maxHead(0),
+      maxSize(0),
+      sequence(0),
+      summary(),
+      summaryValid(false) {
+}
+
+void FrameStats::addSample(float frameTime) {
+    if (frameTime < 0.0f) frameTime = 0.0f;
+    
+    size_t window = samples.size();
+    size_t slot = sequence % window;
+    
+    // Evict the oldest sample once the window is full
+    if (count == window) {
+        float old = samples[slot];
+        size_t oldBin = binFor(old);
+        histogram[oldBin]--;
+        if (oldBin == BIN_COUNT - 1) overflowSum -= old;
+        sum -= old;
+        sumSquares -= static_cast<double>(old) * old;
+        if (old > budget) overBudgetInWindow--;
+        
+        if (maxSize > 0 && maxQueue[maxHead] + window <= sequence) {
+            maxHead = (maxHead + 1) % window;
+            maxSize--;
+        }
+    } else {
+        count++;
+    }
+    
+    samples[slot] = frameTime;
+    size_t bin = binFor(frameTime);
+    histogram[bin]++;
+    if (bin == BIN_COUNT - 1) overflowSum += frameTime;
+    sum += frameTime;
+    sumSquares += static_cast<double>(frameTime) * frameTime;
+    if (frameTime > budget) {
+        overBudgetInWindow++;
+        overBudgetTotal++;
+    }
+    
+    pushMax(frameTime);
+    sequence++;
+    summaryValid = false;
+}
+
+void FrameStats::reset() {
+    std::fill(histogram.begin(), histogram.end(), 0);
+    count = 0;
+    overflowSum = 0.0;
+    sum = 0.0;
+    sumSquares = 0.0;
+    overBudgetInWindow = 0;
+    overBudgetTotal = 0;
+    maxHead = 0;
+    maxSize = 0;
+    sequence = 0;
+    summaryValid = false;
+}
+
+void FrameStats::setWindowSize(size_t windowSize) {
+    samples.assign(windowSize > 0 ? windowSize : 1, 0.0f);
+    maxQueue.assign(samples.size(), 0);
+    reset();
+}
+
+void FrameStats::setBudget(float newBudget) {
+    budget = newBudget;
+    
+    // Recount the window against the new budget
+    overBudgetInWindow = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (samples[(sequence - 1 - i) % samples.size()] > budget) {
+            overBudgetInWindow++;
+        }
+    }
+    summaryValid = false;
+}
+
+float FrameStats::getAverage() const {
+    return count > 0 ? static_cast<float>(sum / count) : 0.0f;
+}
+
+float FrameStats::getStdDev() const {
+    if (count < 2) return 0.0f;
+    
+    double mean = sum / count;
+    double variance = (sumSquares - mean * sum) / (count - 1);
+    return variance > 0.0 ? static_cast<float>(std::sqrt(variance)) : 0.0f;
+}
+
+float FrameStats::getMax() const {
+    if (maxSize == 0) return 0.0f;
+    return samples[maxQueue[maxHead] % samples.size()];
+}
+
+float FrameStats::getPercentile(float percentile) const {
+    float result = 0.0f;
+    findPercentiles(&percentile, &result, 1);
+    return result;
+}
+
+void FrameStats::findPercentiles(const float* percentiles, float* results, size_t n) const {
+    // Percentiles must be ascending; all are found in one walk up the histogram
+    float maxTime = getMax();
+    size_t seen = 0;
+    size_t bin = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (count == 0) {
+            results[i] = 0.0f;
+            continue;
+        }
+        
+        size_t rank = static_cast<size_t>(std::ceil(percentiles[i] / 100.0f * count));
+        rank = std::min(std::max(rank, static_cast<size_t>(1)), count);
+        
+        while (bin < BIN_COUNT - 1 && seen + histogram[bin] < rank) {
+            seen += histogram[bin];
+            bin++;
+        }
+        
+        // Upper edge of the bin, but never above the real maximum
+        results[i] = bin < BIN_COUNT - 1 ? std::min((bin + 1) * BIN_WIDTH, maxTime) : maxTime;
+    }
+}
+
+float FrameStats::getLowFPS(float fraction) const {
+    if (count == 0) return 0.0f;
+    
+    size_t wanted = static_cast<size_t>(std::round(fraction * count));
+    if (wanted == 0) wanted = 1;
+    
+    // Walk down from the slowest bin, summing the worst frames
+    double total = 0.0;
+    size_t taken = 0;
+    size_t overflow = histogram[BIN_COUNT - 1];
+    if (overflow > 0) {
+        size_t use = std::min(overflow, wanted);
+        total += overflowSum * use / overflow;
+        taken += use;
+    }
+    
+    for (size_t bin = BIN_COUNT - 1; bin-- > 0 && taken < wanted;) {
+        size_t use = std::min(static_cast<size_t>(histogram[bin]), wanted - taken);
+        total += use * (bin + 0.5) * BIN_WIDTH;
+        taken += use;
+    }
+    
+    double average = total / taken;
+    return average > 0.0 ? static_cast<float>(1.0 / average) : 0.0f;
+}
+
+const FrameStats::Summary& FrameStats::getSummary() const {
+    if (!summaryValid) {
+        summary.average = getAverage();
+        summary.stdDev = getStdDev();
+        const float percentiles[3] = { 50.0f, 95.0f, 99.0f };
+        float results[3];
+        findPercentiles(percentiles, results, 3);
+        summary.p50 = results[0];
+        summary.p95 = results[1];
+        summary.p99 = results[2];
+        summary.max = getMax();
+        summary.low1 = getLowFPS(0.01f);
+        summary.low01 = getLowFPS(0.001f);
+        summary.overBudget = overBudgetInWindow;
+        summary.sampleCount = count;
+        summaryValid = true;
+    }
+    return summary;
+}
+
+size_t FrameStats::binFor(float frameTime) const {
+    size_t bin = static_cast<size_t>(frameTime / BIN_WIDTH);
+    return bin < BIN_COUNT - 1 ? bin : BIN_COUNT - 1;
+}
+
+void FrameStats::pushMax(float frameTime) {
+    // Drop queued samples that can never be the maximum again
+    size_t window = samples.size();
+    while (maxSize > 0) {
+        size_t back = (maxHead + maxSize - 1) % window;
+        if (samples[maxQueue[back] % window] > frameTime) break;
+        maxSize--;
+    }
+    
+    maxQueue[(maxHead + maxSize) % window] = sequence;
+    maxSize++;
+}
+
+} // namespace ENGAIN
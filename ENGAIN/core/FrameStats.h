@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ENGAIN {
+
+// Frame time statistics over a sliding window of recent frames. Samples go
+// into a ring buffer and a histogram with 0.1 ms bins, so adding a sample
+// is O(1) and queries never sort. Times are in seconds.
+class FrameStats {
+public:
+    struct Summary {
+        float average;
+        float stdDev;
+        float p50;
+        float p95;
+        float p99;
+        float max;
+        float low1;     // Average FPS over the slowest 1% of frames
+        float low01;    // Average FPS over the slowest 0.1% of frames
+        unsigned int overBudget;
+        size_t sampleCount;
+    };
+    
+    explicit FrameStats(size_t windowSize = 600, float budget = 1.0f / 60.0f);
+    
+    void addSample(float frameTime);
+    void reset();
+    
+    // Changing the window size clears the collected samples
+    void setWindowSize(size_t windowSize);
+    void setBudget(float budget);
+    
+    size_t getWindowSize() const { return samples.size(); }
+    size_t getSampleCount() const { return count; }
+    float getBudget() const { return budget; }
+    
+    float getAverage() const;
+    float getStdDev() const;
+    float getMax() const;
+    // Frame time at the given percentile (0..100), accurate to one bin
+    float getPercentile(float percentile) const;
+    // Average FPS over the slowest fraction of frames (0.01 for the 1% low)
+    float getLowFPS(float fraction) const;
+    // Frames in the window that took longer than the budget
+    unsigned int getOverBudgetCount() const { return overBudgetInWindow; }
+    // Frames over budget since the last reset
+    uint64_t getTotalOverBudgetCount() const { return overBudgetTotal; }
+    
+    // All of the above, computed once and cached until the next sample
+    const Summary& getSummary() const;
+
+private:
+    static const size_t BIN_COUNT = 1000;
+    static constexpr float BIN_WIDTH = 0.0001f;
+    
+    size_t binFor(float frameTime) const;
+    void findPercentiles(const float* percentiles, float* results, size_t n) const;
+    void pushMax(float frameTime);
+    
+    float budget;
+    
+    // Ring buffer of the window; sample n lives at n % window size
+    std::vector<float> samples;
+    size_t count;
+    
+    // Histogram of the window; the last bin collects everything slower
+    // than 100 ms and keeps an exact sum for it
+    std::vector<uint32_t> histogram;
+    double overflowSum;
+    
+    double sum;
+    double sumSquares;
+    unsigned int overBudgetInWindow;
+    uint64_t overBudgetTotal;
+    
+    // Monotonic queue of sample sequence numbers for the window maximum
+    std::vector<uint64_t> maxQueue;
+    size_t maxHead;
+    size_t maxSize;
+    uint64_t sequence;
+    
+    mutable Summary summary;
+    mutable bool summaryValid;
+};
+
+} // namespace ENGAIN
@@ -1,8 +1,32 @@
 #include "Input.h"
+#include "EventDispatcher.h"
 
 namespace ENGAIN {
 
-Input::Input() {}
+namespace {
+    int toIndex(SDL_Keycode key) {
+        int scancode = static_cast<int>(SDL_GetScancodeFromKey(key));
+        return scancode > 0 && scancode < SDL_NUM_SCANCODES ? scancode : -1;
+    }
+}
+
+Input::Input()
+    : keyDown(),
+      pressedFrame(),
+      releasedFrame(),
+      frame(0) {
+    // Keys already held when input is first used
+    int keyCount = 0;
+    const Uint8* state = SDL_GetKeyboardState(&keyCount);
+    for (int i = 0; i < keyCount && i < SDL_NUM_SCANCODES; i++) {
+        keyDown[i] = state[i] != 0;
+    }
+    
+    EventDispatcher& events = EventDispatcher::getInstance();
+    auto listener = [this](const SDL_Event& event) { handleKey(event); };
+    events.subscribe(SDL_KEYDOWN, listener);
+    events.subscribe(SDL_KEYUP, listener);
+}
 
 Input& Input::getInstance() {
     static Input instance;
@@ -10,47 +34,39 @@ Input& Input::getInstance() {
 }
 
 void Input::update() {
-    previousKeys = currentKeys;
-    
-    const Uint8* keyState = SDL_GetKeyboardState(nullptr);
-    
-    // Update common keys
-    SDL_Keycode keys[] = {
-        SDLK_w, SDLK_a, SDLK_s, SDLK_d,
-        SDLK_UP, SDLK_DOWN, SDLK_LEFT, SDLK_RIGHT,
-        SDLK_SPACE, SDLK_ESCAPE, SDLK_RETURN,
-        SDLK_LSHIFT, SDLK_RSHIFT
-    };
+    frame = EventDispatcher::getInstance().getFrameNumber();
+}
+
+void Input::handleKey(const SDL_Event& event) {
+    int scancode = static_cast<int>(event.key.keysym.scancode);
+    if (scancode <= 0 || scancode >= SDL_NUM_SCANCODES) return;
     
-    for (SDL_Keycode key : keys) {
-        SDL_Scancode scancode = SDL_GetScancodeFromKey(key);
-        currentKeys[key] = keyState[scancode];
+    uint64_t eventFrame = EventDispatcher::getInstance().getFrameNumber();
+    if (event.type == SDL_KEYDOWN) {
+        // Auto-repeat is not a new press
+        if (!event.key.repeat) {
+            pressedFrame[scancode] = eventFrame;
+        }
+        keyDown[scancode] = true;
+    } else {
+        releasedFrame[scancode] = eventFrame;
+        keyDown[scancode] = false;
     }
 }
 
 bool Input::isKeyDown(SDL_Keycode key) const {
-    auto it = currentKeys.find(key);
-    return it != currentKeys.end() && it->second;
+    int index = toIndex(key);
+    return index >= 0 && keyDown[index];
 }
 
 bool Input::isKeyPressed(SDL_Keycode key) const {
-    auto curr = currentKeys.find(key);
-    auto prev = previousKeys.find(key);
-    
-    bool currentlyDown = (curr != currentKeys.end() && curr->second);
-    bool previouslyDown = (prev != previousKeys.end() && prev->second);
-    
-    return currentlyDown && !previouslyDown;
+    int index = toIndex(key);
+    return index >= 0 && frame != 0 && pressedFrame[index] == frame;
 }
 
 bool Input::isKeyReleased(SDL_Keycode key) const {
-    auto curr = currentKeys.find(key);
-    auto prev = previousKeys.find(key);
-    
-    bool currentlyDown = (curr != currentKeys.end() && curr->second);
-    bool previouslyDown = (prev != previousKeys.end() && prev->second);
-    
-    return !currentlyDown && previouslyDown;
+    int index = toIndex(key);
+    return index >= 0 && frame != 0 && releasedFrame[index] == frame;
 }
 
 } // namespace ENGAIN
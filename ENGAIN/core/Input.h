@@ -1,14 +1,17 @@
 #pragma once
 
 #include <SDL2/SDL.h>
-#include <unordered_map>
+#include <cstdint>
 
 namespace ENGAIN {
 
+// Keyboard state built from the key events the EventDispatcher delivers, so
+// every key is tracked and presses shorter than a frame are not missed.
 class Input {
 public:
     static Input& getInstance();
     
+    // Latch the presses and releases of this frame; call after Window::handleEvents()
     void update();
     
     bool isKeyDown(SDL_Keycode key) const;
@@ -20,8 +23,15 @@ private:
     Input(const Input&) = delete;
     Input& operator=(const Input&) = delete;
     
-    std::unordered_map<SDL_Keycode, bool> currentKeys;
-    std::unordered_map<SDL_Keycode, bool> previousKeys;
+    void handleKey(const SDL_Event& event);
+    
+    // Indexed by scancode
+    bool keyDown[SDL_NUM_SCANCODES];
+    // Dispatcher frame of the last press and release, 0 for never
+    uint64_t pressedFrame[SDL_NUM_SCANCODES];
+    uint64_t releasedFrame[SDL_NUM_SCANCODES];
+    
+    uint64_t frame;
 };
 
 } // namespace ENGAIN
@@ -0,0 +1,82 @@
+#include "LogQueue.h"
+#include <cstring>
+
+namespace ENGAIN {
+
+LogQueue::LogQueue(size_t capacity) : mask(0), enqueuePos(0), dequeuePos(0) {
+    // Round capacity up to a power of two so positions can be masked
+    size_t size = 2;
+    while (size < capacity) {
+        size <<= 1;
+    }
+    mask = size - 1;
+    
+    slots.reset(new Slot[size]);
+    for (size_t i = 0; i < size; i++) {
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+bool LogQueue::tryPush(LogLevel level, std::chrono::system_clock::time_point time,
+                       const std::string& message) {
+    Slot* slot;
+    size_t pos = enqueuePos.load(std::memory_order_relaxed);
+    
+    for (;;) {
+        slot = &slots[pos & mask];
+        size_t sequence = slot->sequence.load(std::memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+        
+        if (diff == 0) {
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false; // Full
+        } else {
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+    
+    LogRecord& record = slot->record;
+    record.time = time;
+    record.level = level;
+    record.length = static_cast<uint32_t>(
+        message.size() < LogRecord::MAX_MESSAGE_LENGTH ? message.size() : LogRecord::MAX_MESSAGE_LENGTH);
+    std::memcpy(record.message, message.data(), record.length);
+    
+    slot->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+bool LogQueue::tryPop(LogRecord& record) {
+    Slot* slot;
+    size_t pos = dequeuePos.load(std::memory_order_relaxed);
+    
+    for (;;) {
+        slot = &slots[pos & mask];
+        size_t sequence = slot->sequence.load(std::memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+        
+        if (diff == 0) {
+            if (dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false; // Empty
+        } else {
+            pos = dequeuePos.load(std::memory_order_relaxed);
+        }
+    }
+    
+    const LogRecord& stored = slot->record;
+    record.time = stored.time;
+    record.level = stored.level;
+    record.length = stored.length;
+    std::memcpy(record.message, stored.message, stored.length);
+    
+    slot->sequence.store(pos + mask + 1, std::memory_order_release);
+    return true;
+}
+
+} // namespace ENGAIN
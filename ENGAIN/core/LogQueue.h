@@ -0,0 +1,54 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace ENGAIN {
+
+enum class LogLevel;
+
+// Fixed-size log entry passed from the calling thread to the writer thread.
+// Messages longer than MAX_MESSAGE_LENGTH are truncated.
+struct LogRecord {
+    static const size_t MAX_MESSAGE_LENGTH = 480;
+    
+    std::chrono::system_clock::time_point time;
+    LogLevel level;
+    uint32_t length;
+    char message[MAX_MESSAGE_LENGTH];
+};
+
+// Bounded lock-free queue of LogRecords (Vyukov sequence-per-slot ring).
+// Any number of threads may push; popping is also safe from several threads,
+// which lets a producer discard the oldest entry when the queue is full.
+class LogQueue {
+public:
+    explicit LogQueue(size_t capacity);
+    
+    bool tryPush(LogLevel level, std::chrono::system_clock::time_point time,
+                 const std::string& message);
+    bool tryPop(LogRecord& record);
+    
+    size_t getCapacity() const { return mask + 1; }
+
+private:
+    LogQueue(const LogQueue&) = delete;
+    LogQueue& operator=(const LogQueue&) = delete;
+    
+    struct Slot {
+        std::atomic<size_t> sequence;
+        LogRecord record;
+    };
+    
+    std::unique_ptr<Slot[]> slots;
+    size_t mask;
+    
+    alignas(64) std::atomic<size_t> enqueuePos;
+    alignas(64) std::atomic<size_t> dequeuePos;
+};
+
+} // namespace ENGAIN
@@ -0,0 +1,47 @@
+#include "LogThrottle.h"
+#include <chrono>
+#include <ctime>
+
+namespace ENGAIN {
+
+namespace {
+    // A suppressed call checks the time on every call, so it uses the coarse
+    // clock where there is one: a few milliseconds of resolution, read from
+    // memory without a system call.
+    int64_t nowNanoseconds() {
+#ifdef CLOCK_MONOTONIC_COARSE
+        timespec now;
+        clock_gettime(CLOCK_MONOTONIC_COARSE, &now);
+        return static_cast<int64_t>(now.tv_sec) * 1000000000 + now.tv_nsec;
+#else
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+}
+
+LogThrottle::LogThrottle(unsigned int maxPerInterval, float intervalSeconds)
+    : maxPerInterval(maxPerInterval > 0 ? maxPerInterval : 1),
+      intervalNs(static_cast<int64_t>(intervalSeconds * 1e9f)),
+      counter(0),
+      windowEnd(nowNanoseconds() + intervalNs) {
+}
+
+bool LogThrottle::allowSlow(unsigned int count, unsigned int& suppressed) {
+    int64_t now = nowNanoseconds();
+    int64_t end = windowEnd.load(std::memory_order_relaxed);
+    if (now < end) {
+        return false;
+    }
+    
+    // Interval is over: the thread that wins the exchange starts a new window
+    if (!windowEnd.compare_exchange_strong(end, now + intervalNs, std::memory_order_relaxed)) {
+        return false;
+    }
+    
+    counter.store(1, std::memory_order_relaxed);
+    suppressed = count - maxPerInterval;
+    return true;
+}
+
+} // namespace ENGAIN
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include "Logger.h"
+
+namespace ENGAIN {
+
+// Rate limiter for a single log call site: lets maxPerInterval messages
+// through per interval and counts the rest. Every call costs one atomic
+// increment. A suppressed call also reads the coarse monotonic clock (a vDSO
+// read on Linux, no system call) and compares it with the window end, a few
+// nanoseconds more; intervals are only as exact as that clock, a few ms.
+class LogThrottle {
+public:
+    LogThrottle(unsigned int maxPerInterval, float intervalSeconds);
+    
+    // Returns true if this message should be logged. suppressed receives how
+    // many messages were dropped since the last one that got through.
+    bool allow(unsigned int& suppressed) {
+        unsigned int count = counter.fetch_add(1, std::memory_order_relaxed);
+        if (count < maxPerInterval) {
+            suppressed = 0;
+            return true;
+        }
+        return allowSlow(count, suppressed);
+    }
+
+private:
+    bool allowSlow(unsigned int count, unsigned int& suppressed);
+    
+    const unsigned int maxPerInterval;
+    const int64_t intervalNs;
+    std::atomic<unsigned int> counter;
+    std::atomic<int64_t> windowEnd;
+};
+
+} // namespace ENGAIN
+
+// Logs at most maxPerInterval messages per intervalSeconds from this call site,
+// then appends "(suppressed N repeats)" to the next message that gets through.
+#define ENGAIN_LOG_THROTTLED(level, channel, maxPerInterval, intervalSeconds, expr) \
+    do { \
+        if (static_cast<int>(level) >= ENGAIN_MIN_LOG_LEVEL && \
+            ::ENGAIN::Logger::getInstance().isEnabled(level, ::ENGAIN::LogChannel::channel)) { \
+            static ::ENGAIN::LogThrottle engainThrottle_(maxPerInterval, intervalSeconds); \
+            unsigned int engainSuppressed_ = 0; \
+            if (engainThrottle_.allow(engainSuppressed_)) { \
+                if (engainSuppressed_ > 0) { \
+                    ENGAIN_LOG(level, channel, expr << " (suppressed " << engainSuppressed_ << " repeats)"); \
+                } else { \
+                    ENGAIN_LOG(level, channel, expr); \
+                } \
+            } \
+        } \
+    } while (0)
@@ -1,17 +1,55 @@
 #include "Logger.h"
+#include "BinaryLog.h"
 #include <filesystem>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
 
 namespace ENGAIN {
 
-Logger::Logger() : currentLevel(LogLevel::DEBUG), initialized(false) {}
+namespace {
+    // Upper bound on records formatted before each batched write
+    const size_t MAX_BATCH_RECORDS = 256;
+    // How long the writer thread sleeps when the queue is empty
+    const std::chrono::milliseconds WRITER_IDLE_WAIT(10);
+    
+    const char* CHANNEL_NAMES[] = {
+        "general", "window", "render", "assets", "input", "time"
+    };
+    
+    bool parseLevel(const std::string& name, LogLevel& level) {
+        if (name == "debug")    { level = LogLevel::DEBUG;    return true; }
+        if (name == "info")     { level = LogLevel::INFO;     return true; }
+        if (name == "warning")  { level = LogLevel::WARNING;  return true; }
+        if (name == "error")    { level = LogLevel::ERROR;    return true; }
+        if (name == "critical") { level = LogLevel::CRITICAL; return true; }
+        return false;
+    }
+}
 
-Logger::~Logger() {
-    if (logFile.is_open()) {
-        info("Logger shutting down");
-        logFile.close();
+Logger::Logger()
+    : currentLevel(LogLevel::DEBUG),
+      rotationEnabled(false),
+      initialized(false),
+      recentHead(0),
+      recentSize(0),
+      overflowPolicy(LogOverflowPolicy::DROP),
+      asyncEnabled(false),
+      writerRunning(false),
+      writerSleeping(false),
+      enqueuedCount(0),
+      processedCount(0),
+      droppedCount(0) {
+    
+    for (auto& channelLevel : channelLevels) {
+        channelLevel.store(-1, std::memory_order_relaxed);
     }
 }
 
+Logger::~Logger() {
+    shutdown();
+}
+
 Logger& Logger::getInstance() {
     static Logger instance;
     return instance;
@@ -32,18 +70,187 @@ void Logger::initialize(const std::string& logDir) {
              << std::put_time(localTime, "%Y%m%d_%H%M%S")
              << ".log";
     
-    logFile.open(filename.str(), std::ios::out | std::ios::app);
+    {
+        std::lock_guard<std::mutex> lock(fileMutex);
+        
+        // Rotating memory-mapped files when configured, one plain file otherwise
+        if (rotationEnabled) {
+            mappedFile.reset(new MappedLogFile());
+            if (!mappedFile->open(logDir, rotationConfig)) {
+                mappedFile.reset();
+                std::cerr << "Log rotation unavailable, using a single log file" << std::endl;
+            }
+        }
+        
+        if (mappedFile) {
+            initialized = true;
+        } else {
+            logFile.open(filename.str(), std::ios::out | std::ios::app);
+            initialized = logFile.is_open();
+        }
+    }
     
-    if (logFile.is_open()) {
-        initialized = true;
+    if (initialized) {
         info("Logger initialized");
+        if (mappedFile) {
+            std::ostringstream oss;
+            oss << "Log rotation enabled: " << rotationConfig.maxFileSize / 1024 << " KB per file, keeping "
+                << rotationConfig.maxFiles << " files";
+            info(oss.str());
+        }
     } else {
         std::cerr << "Failed to open log file: " << filename.str() << std::endl;
     }
+    
+    if (const char* channels = std::getenv("ENGAIN_LOG_CHANNELS")) {
+        configureChannels(channels);
+    }
+    
+    // Structured ENGAIN_LOGF_* calls go to a binary log when requested
+    if (std::getenv("ENGAIN_BINARY_LOG")) {
+        BinaryLog::getInstance().open(logDir);
+    }
+}
+
+void Logger::setRotation(const LogRotationConfig& config) {
+    rotationConfig = config;
+    rotationEnabled = true;
 }
 
 void Logger::setLevel(LogLevel level) {
-    currentLevel = level;
+    currentLevel.store(level, std::memory_order_relaxed);
+}
+
+void Logger::setChannelLevel(LogChannel channel, LogLevel level) {
+    channelLevels[static_cast<int>(channel)].store(static_cast<int>(level), std::memory_order_relaxed);
+}
+
+bool Logger::setChannelLevel(const std::string& channelName, LogLevel level) {
+    for (int i = 0; i < static_cast<int>(LogChannel::COUNT); i++) {
+        if (channelName == CHANNEL_NAMES[i]) {
+            setChannelLevel(static_cast<LogChannel>(i), level);
+            return true;
+        }
+    }
+    return false;
+}
+
+void Logger::resetChannelLevel(LogChannel channel) {
+    channelLevels[static_cast<int>(channel)].store(-1, std::memory_order_relaxed);
+}
+
+void Logger::configureChannels(const std::string& spec) {
+    // Comma separated "channel=level" pairs
+    std::istringstream stream(spec);
+    std::string entry;
+    
+    while (std::getline(stream, entry, ',')) {
+        entry.erase(std::remove(entry.begin(), entry.end(), ' '), entry.end());
+        size_t separator = entry.find('=');
+        if (separator == std::string::npos) continue;
+        
+        std::string channelName = entry.substr(0, separator);
+        std::string levelName = entry.substr(separator + 1);
+        std::transform(levelName.begin(), levelName.end(), levelName.begin(), ::tolower);
+        std::transform(channelName.begin(), channelName.end(), channelName.begin(), ::tolower);
+        
+        LogLevel level;
+        if (!parseLevel(levelName, level) || !setChannelLevel(channelName, level)) {
+            warning("Ignoring invalid log channel setting: " + entry);
+            continue;
+        }
+        info("Log channel '" + channelName + "' set to " + levelName);
+    }
+}
+
+void Logger::enableAsync(size_t queueCapacity, LogOverflowPolicy policy) {
+    if (asyncEnabled.load(std::memory_order_acquire)) return;
+    
+    queue.reset(new LogQueue(queueCapacity));
+    overflowPolicy = policy;
+    
+    writerRunning.store(true, std::memory_order_release);
+    writerThread = std::thread(&Logger::writerLoop, this);
+    asyncEnabled.store(true, std::memory_order_release);
+    
+    std::ostringstream oss;
+    oss << "Asynchronous logging enabled (queue capacity: " << queue->getCapacity() << ")";
+    info(oss.str());
+}
+
+void Logger::flush() {
+    if (asyncEnabled.load(std::memory_order_acquire)) {
+        unsigned long long target = enqueuedCount.load(std::memory_order_acquire);
+        
+        std::unique_lock<std::mutex> lock(writerMutex);
+        writerWake.notify_one();
+        writerDone.wait(lock, [&] {
+            return processedCount.load(std::memory_order_acquire) >= target ||
+                   !writerRunning.load(std::memory_order_acquire);
+        });
+    }
+    
+    BinaryLog::getInstance().flush();
+    
+    std::lock_guard<std::mutex> lock(fileMutex);
+    flushFile();
+    std::cout.flush();
+}
+
+void Logger::shutdown() {
+    if (initialized) {
+        info("Logger shutting down");
+    }
+    
+    // Stop the writer; it drains the queue before exiting
+    if (asyncEnabled.exchange(false, std::memory_order_seq_cst)) {
+        {
+            std::lock_guard<std::mutex> lock(writerMutex);
+            writerRunning.store(false, std::memory_order_release);
+        }
+        writerWake.notify_one();
+        if (writerThread.joinable()) {
+            writerThread.join();
+        }
+        
+        // Every write() registered before it saw the flag, so once the
+        // counts meet no record can still be on its way into the queue.
+        // fileMutex is taken per record: writers that saw the flag cleared
+        // need it to finish and count themselves.
+        std::unique_ptr<LogRecord> record(new LogRecord());
+        std::string line;
+        while (processedCount.load(std::memory_order_acquire) <
+               enqueuedCount.load(std::memory_order_seq_cst)) {
+            if (!queue->tryPop(*record)) {
+                std::this_thread::yield();
+                continue;
+            }
+            line.clear();
+            formatLine(line, record->time, record->level, record->message, record->length);
+            {
+                std::lock_guard<std::mutex> lock(fileMutex);
+                if (record->level >= LogLevel::INFO) {
+                    std::cout << line;
+                }
+                keepRecent(line.data(), line.size());
+                if (initialized) {
+                    writeToFile(line.data(), line.size());
+                }
+            }
+            processedCount.fetch_add(1, std::memory_order_release);
+        }
+        std::cout.flush();
+    }
+    
+    std::lock_guard<std::mutex> lock(fileMutex);
+    if (mappedFile) {
+        mappedFile->close();
+        mappedFile.reset();
+    }
+    if (logFile.is_open()) {
+        logFile.close();
+    }
+    initialized = false;
 }
 
 void Logger::debug(const std::string& message) {
@@ -67,36 +274,230 @@ void Logger::critical(const std::string& message) {
 }
 
 void Logger::log(LogLevel level, const std::string& message) {
-    if (level < currentLevel) return;
+    if (!isEnabled(level)) return;
+    write(level, message);
+}
+
+void Logger::log(LogLevel level, LogChannel channel, const std::string& message) {
+    if (!isEnabled(level, channel)) return;
+    write(level, message);
+}
+
+void Logger::write(LogLevel level, const std::string& message) {
+    // Registered before the flag is read, so shutdown() either sees this
+    // record counted or this call sees asynchronous logging already off
+    enqueuedCount.fetch_add(1, std::memory_order_seq_cst);
+    if (asyncEnabled.load(std::memory_order_seq_cst)) {
+        enqueue(level, message);
+        return;
+    }
     
-    std::string timestamp = getCurrentTime();
-    std::string levelStr = levelToString(level);
+    writeDirect(level, message);
+    processedCount.fetch_add(1, std::memory_order_release);
+}
+
+void Logger::writeDirect(LogLevel level, const std::string& message) {
+    std::lock_guard<std::mutex> lock(fileMutex);
     
-    std::ostringstream logMessage;
-    logMessage << "[" << timestamp << "] [" << levelStr << "] " << message;
+    std::string logMessage;
+    formatLine(logMessage, std::chrono::system_clock::now(), level, message.data(), message.size());
     
     // Write to console
     if (level >= LogLevel::INFO) {
-        std::cout << logMessage.str() << std::endl;
+        std::cout << logMessage;
+        std::cout.flush();
+    }
+    
+    keepRecent(logMessage.data(), logMessage.size());
+    
+    // Write to file. Mapped files are synced in the background instead.
+    if (initialized) {
+        writeToFile(logMessage.data(), logMessage.size());
+        if (!mappedFile) {
+            flushFile();
+        }
+    }
+}
+
+void Logger::enqueue(LogLevel level, const std::string& message) {
+    // Already counted by write(); a dropped record counts as processed
+    auto now = std::chrono::system_clock::now();
+    
+    while (!queue->tryPush(level, now, message)) {
+        switch (overflowPolicy) {
+            case LogOverflowPolicy::DROP:
+                droppedCount.fetch_add(1, std::memory_order_relaxed);
+                processedCount.fetch_add(1, std::memory_order_release);
+                return;
+            
+            case LogOverflowPolicy::BLOCK:
+                // After the writer stops, shutdown() drains the queue instead
+                writerWake.notify_one();
+                std::this_thread::yield();
+                break;
+            
+            case LogOverflowPolicy::OVERWRITE_OLDEST: {
+                LogRecord discarded;
+                if (queue->tryPop(discarded)) {
+                    droppedCount.fetch_add(1, std::memory_order_relaxed);
+                    processedCount.fetch_add(1, std::memory_order_release);
+                }
+                break;
+            }
+        }
+    }
+    
+    if (writerSleeping.load(std::memory_order_relaxed)) {
+        writerWake.notify_one();
+    }
+}
+
+void Logger::writerLoop() {
+    std::unique_ptr<LogRecord> record(new LogRecord());
+    std::string fileBatch;
+    std::string consoleBatch;
+    fileBatch.reserve(64 * 1024);
+    consoleBatch.reserve(16 * 1024);
+    
+    for (;;) {
+        // Format a batch of records, then write it with a single call
+        size_t count = 0;
+        while (count < MAX_BATCH_RECORDS && queue->tryPop(*record)) {
+            size_t start = fileBatch.size();
+            formatLine(fileBatch, record->time, record->level, record->message, record->length);
+            if (record->level >= LogLevel::INFO) {
+                consoleBatch.append(fileBatch, start, std::string::npos);
+            }
+            count++;
+        }
+        
+        if (count > 0) {
+            if (!consoleBatch.empty()) {
+                std::cout.write(consoleBatch.data(), consoleBatch.size());
+                consoleBatch.clear();
+            }
+            {
+                std::lock_guard<std::mutex> lock(fileMutex);
+                keepRecent(fileBatch.data(), fileBatch.size());
+                if (initialized) {
+                    writeToFile(fileBatch.data(), fileBatch.size());
+                }
+            }
+            fileBatch.clear();
+            processedCount.fetch_add(count, std::memory_order_release);
+            continue;
+        }
+        
+        // Queue is empty - flush what has been written and wake any flush() callers
+        {
+            std::lock_guard<std::mutex> lock(fileMutex);
+            flushFile();
+        }
+        std::cout.flush();
+        
+        std::unique_lock<std::mutex> lock(writerMutex);
+        writerDone.notify_all();
+        
+        // Records still arriving are left to shutdown()
+        if (!writerRunning.load(std::memory_order_acquire)) {
+            break;
+        }
+        
+        writerSleeping.store(true, std::memory_order_relaxed);
+        writerWake.wait_for(lock, WRITER_IDLE_WAIT);
+        writerSleeping.store(false, std::memory_order_relaxed);
+    }
+}
+
+void Logger::writeToFile(const char* data, size_t length) {
+    if (mappedFile) {
+        mappedFile->write(data, length);
+    } else if (logFile.is_open()) {
+        logFile.write(data, length);
+    }
+}
+
+void Logger::keepRecent(const char* data, size_t length) {
+    size_t capacity = recentLog.size();
+    if (capacity == 0) return;
+    
+    // Only the tail of an oversized write can fit
+    if (length > capacity) {
+        data += length - capacity;
+        length = capacity;
+    }
+    
+    size_t first = std::min(length, capacity - recentHead);
+    std::memcpy(recentLog.data() + recentHead, data, first);
+    std::memcpy(recentLog.data(), data + first, length - first);
+    recentHead = (recentHead + length) % capacity;
+    recentSize = std::min(recentSize + length, capacity);
+}
+
+void Logger::setRecentLogCapacity(size_t bytes) {
+    std::lock_guard<std::mutex> lock(fileMutex);
+    recentLog.assign(bytes, '\0');
+    recentHead = 0;
+    recentSize = 0;
+}
+
+std::string Logger::getRecentLog() {
+    std::lock_guard<std::mutex> lock(fileMutex);
+    
+    std::string text;
+    if (recentSize < recentLog.size()) {
+        text.assign(recentLog.data(), recentSize);
+    } else {
+        // Full ring: the oldest byte is at the head
+        text.assign(recentLog.data() + recentHead, recentLog.size() - recentHead);
+        text.append(recentLog.data(), recentHead);
     }
     
-    // Write to file
-    if (initialized && logFile.is_open()) {
-        logFile << logMessage.str() << std::endl;
+    // Once the ring has wrapped, the first line is usually cut off
+    if (recentSize == recentLog.size() && !text.empty()) {
+        size_t newline = text.find('\n');
+        text.erase(0, newline == std::string::npos ? text.size() : newline + 1);
+    }
+    return text;
+}
+
+void Logger::flushFile() {
+    if (mappedFile) {
+        mappedFile->flush();
+    } else if (logFile.is_open()) {
         logFile.flush();
     }
 }
 
-std::string Logger::getCurrentTime() {
-    std::time_t now = std::time(nullptr);
-    std::tm* localTime = std::localtime(&now);
+void Logger::formatLine(std::string& out, std::chrono::system_clock::time_point time,
+                        LogLevel level, const char* message, size_t length) {
+    // Timestamps only change once per second, so reuse the last one. Per
+    // thread, since the writer and the sync path can format at the same time.
+    thread_local std::time_t cachedSecond = 0;
+    thread_local char cachedTimestamp[32] = {};
     
-    std::ostringstream oss;
-    oss << std::put_time(localTime, "%Y-%m-%d %H:%M:%S");
-    return oss.str();
+    std::time_t seconds = std::chrono::system_clock::to_time_t(time);
+    if (seconds != cachedSecond || cachedTimestamp[0] == '\0') {
+        std::tm localTime;
+#ifdef _WIN32
+        localtime_s(&localTime, &seconds);
+#else
+        localtime_r(&seconds, &localTime);
+#endif
+        std::strftime(cachedTimestamp, sizeof(cachedTimestamp), "%Y-%m-%d %H:%M:%S", &localTime);
+        cachedSecond = seconds;
+    }
+    
+    out += '[';
+    out += cachedTimestamp;
+    out += "] [";
+    out += levelToString(level);
+    out += "] ";
+    out.append(message, length);
+    out += '\n';
 }
 
-std::string Logger::levelToString(LogLevel level) {
+const char* Logger::levelToString(LogLevel level) {
     switch (level) {
         case LogLevel::DEBUG:    return "DEBUG";
         case LogLevel::INFO:     return "INFO";
@@ -1,12 +1,19 @@
 #pragma once
 
 #include <string>
+#include <vector>
 #include <fstream>
 #include <iostream>
 #include <memory>
 #include <ctime>
 #include <iomanip>
 #include <sstream>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include "LogQueue.h"
+#include "MappedLogFile.h"
 
 namespace ENGAIN {
 
@@ -18,6 +25,24 @@ enum class LogLevel {
     CRITICAL
 };
 
+// Subsystems whose log level can be set independently at runtime
+enum class LogChannel {
+    GENERAL,
+    WINDOW,
+    RENDER,
+    ASSETS,
+    INPUT,
+    TIME,
+    COUNT
+};
+
+// What an asynchronous log call does when the queue is full
+enum class LogOverflowPolicy {
+    DROP,             // Discard the new message
+    BLOCK,            // Wait for the writer thread to make room
+    OVERWRITE_OLDEST  // Discard the oldest queued message
+};
+
 class Logger {
 public:
     static Logger& getInstance();
@@ -25,6 +50,48 @@ public:
     void initialize(const std::string& logDir = "logs");
     void setLevel(LogLevel level);
     
+    // Write into size/age-rotated memory-mapped files instead of a single
+    // append-only file. Must be called before initialize().
+    void setRotation(const LogRotationConfig& config);
+    
+    // Per-channel levels override the global level until reset. Channels can
+    // also be configured with ENGAIN_LOG_CHANNELS, e.g. "render=debug,assets=info".
+    void setChannelLevel(LogChannel channel, LogLevel level);
+    bool setChannelLevel(const std::string& channelName, LogLevel level);
+    void resetChannelLevel(LogChannel channel);
+    void configureChannels(const std::string& spec);
+    
+    bool isEnabled(LogLevel level, LogChannel channel = LogChannel::GENERAL) const {
+        int threshold = channelLevels[static_cast<int>(channel)].load(std::memory_order_relaxed);
+        if (threshold < 0) {
+            threshold = static_cast<int>(currentLevel.load(std::memory_order_relaxed));
+        }
+        return static_cast<int>(level) >= threshold;
+    }
+    
+    // Used by the ENGAIN_LOG_* macros once the level check has passed
+    void log(LogLevel level, LogChannel channel, const std::string& message);
+    
+    // Hand formatting and file writes to a background thread. Calls then only
+    // copy the message into a bounded lock-free queue.
+    void enableAsync(size_t queueCapacity = 4096,
+                     LogOverflowPolicy policy = LogOverflowPolicy::DROP);
+    bool isAsync() const { return asyncEnabled.load(std::memory_order_acquire); }
+    
+    // Block until every message logged before this call has been written
+    void flush();
+    // Write out any queued messages, stop the writer thread and close the file.
+    // Messages logged concurrently are written before the file closes.
+    void shutdown();
+    
+    unsigned long long getDroppedCount() const { return droppedCount.load(std::memory_order_relaxed); }
+    
+    // Keep the last few kilobytes of formatted output in memory so crash and
+    // hitch reports can include them. 0 turns it off (the default).
+    void setRecentLogCapacity(size_t bytes);
+    // Recently written lines, oldest first, starting at a line boundary
+    std::string getRecentLog();
+    
     void debug(const std::string& message);
     void info(const std::string& message);
     void warning(const std::string& message);
@@ -39,12 +106,94 @@ private:
     Logger& operator=(const Logger&) = delete;
     
     void log(LogLevel level, const std::string& message);
-    std::string getCurrentTime();
-    std::string levelToString(LogLevel level);
+    void write(LogLevel level, const std::string& message);
+    // Format and write on the calling thread
+    void writeDirect(LogLevel level, const std::string& message);
+    void enqueue(LogLevel level, const std::string& message);
+    void writerLoop();
+    void writeToFile(const char* data, size_t length);
+    void keepRecent(const char* data, size_t length);
+    void flushFile();
+    void formatLine(std::string& out, std::chrono::system_clock::time_point time,
+                    LogLevel level, const char* message, size_t length);
+    const char* levelToString(LogLevel level);
     
-    LogLevel currentLevel;
+    std::atomic<LogLevel> currentLevel;
+    std::atomic<int> channelLevels[static_cast<int>(LogChannel::COUNT)];
     std::ofstream logFile;
+    std::unique_ptr<MappedLogFile> mappedFile;
+    LogRotationConfig rotationConfig;
+    bool rotationEnabled;
+    std::mutex fileMutex;
     bool initialized;
+    
+    // Ring of recently written bytes, guarded by fileMutex
+    std::vector<char> recentLog;
+    size_t recentHead;
+    size_t recentSize;
+    
+    // Asynchronous backend
+    std::unique_ptr<LogQueue> queue;
+    LogOverflowPolicy overflowPolicy;
+    std::atomic<bool> asyncEnabled;
+    std::atomic<bool> writerRunning;
+    std::atomic<bool> writerSleeping;
+    std::thread writerThread;
+    std::mutex writerMutex;
+    std::condition_variable writerWake;
+    std::condition_variable writerDone;
+    std::atomic<unsigned long long> enqueuedCount;
+    std::atomic<unsigned long long> processedCount;
+    std::atomic<unsigned long long> droppedCount;
 };
 
 } // namespace ENGAIN
+
+// Log calls below this level are removed at compile time (0 = DEBUG ... 4 = CRITICAL)
+#ifndef ENGAIN_MIN_LOG_LEVEL
+#define ENGAIN_MIN_LOG_LEVEL 0
+#endif
+
+// Stream-style logging. The message is only built when the level is enabled
+// for the channel, e.g. ENGAIN_LOG_DEBUG(WINDOW, "Resized to " << w << "x" << h);
+#define ENGAIN_LOG(level, channel, expr) \
+    do { \
+        ::ENGAIN::Logger& engainLogger_ = ::ENGAIN::Logger::getInstance(); \
+        if (engainLogger_.isEnabled(level, ::ENGAIN::LogChannel::channel)) { \
+            std::ostringstream engainLogStream_; \
+            engainLogStream_ << expr; \
+            engainLogger_.log(level, ::ENGAIN::LogChannel::channel, engainLogStream_.str()); \
+        } \
+    } while (0)
+
+#define ENGAIN_LOG_DISABLED(channel, expr) do {} while (0)
+
+#if ENGAIN_MIN_LOG_LEVEL <= 0
+#define ENGAIN_LOG_DEBUG(channel, expr) ENGAIN_LOG(::ENGAIN::LogLevel::DEBUG, channel, expr)
+#else
+#define ENGAIN_LOG_DEBUG(channel, expr) ENGAIN_LOG_DISABLED(channel, expr)
+#endif
+
+#if ENGAIN_MIN_LOG_LEVEL <= 1
+#define ENGAIN_LOG_INFO(channel, expr) ENGAIN_LOG(::ENGAIN::LogLevel::INFO, channel, expr)
+#else
+#define ENGAIN_LOG_INFO(channel, expr) ENGAIN_LOG_DISABLED(channel, expr)
+#endif
+
+#if ENGAIN_MIN_LOG_LEVEL <= 2
+#define ENGAIN_LOG_WARNING(channel, expr) ENGAIN_LOG(::ENGAIN::LogLevel::WARNING, channel, expr)
+#else
+#define ENGAIN_LOG_WARNING(channel, expr) ENGAIN_LOG_DISABLED(channel, expr)
+#endif
+
+#if ENGAIN_MIN_LOG_LEVEL <= 3
+#define ENGAIN_LOG_ERROR(channel, expr) ENGAIN_LOG(::ENGAIN::LogLevel::ERROR, channel, expr)
+#else
+#define ENGAIN_LOG_ERROR(channel, expr) ENGAIN_LOG_DISABLED(channel, expr)
+#endif
+
+#if ENGAIN_MIN_LOG_LEVEL <= 4
+#define ENGAIN_LOG_CRITICAL(channel, expr) ENGAIN_LOG(::ENGAIN::LogLevel::CRITICAL, channel, expr)
+#else
+#define ENGAIN_LOG_CRITICAL(channel, expr) ENGAIN_LOG_DISABLED(channel, expr)
+#endif
@@ -0,0 +1,392 @@
+#include "MappedLogFile.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define ENGAIN_HAS_MMAP 1
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ENGAIN {
+
+namespace {
+    // How often writes retry opening a file after a failed rotation
+    const std::chrono::seconds REOPEN_INTERVAL(1);
+    // Files grow by this much at a time, which bounds the zero tail a crash leaves
+    const size_t GROW_STEP = 64 * 1024;
+    // Names tried before giving up when they are already taken
+    const int MAX_NAME_ATTEMPTS = 100;
+
+#ifdef ENGAIN_HAS_MMAP
+    // The pid in a segment name, or 0 for names without one
+    long ownerPid(const std::string& name) {
+        size_t start = name.find("_p");
+        if (start == std::string::npos) return 0;
+        char* end = nullptr;
+        long pid = std::strtol(name.c_str() + start + 2, &end, 10);
+        return *end == '_' ? pid : 0;
+    }
+    
+    // Cut a file back to its last non-zero byte
+    void trimZeroTail(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDWR);
+        if (fd < 0) return;
+        
+        struct stat info;
+        if (fstat(fd, &info) != 0) {
+            ::close(fd);
+            return;
+        }
+        off_t length = info.st_size;
+        char buffer[4096];
+        bool found = false;
+        while (length > 0 && !found) {
+            off_t start = std::max<off_t>(length - static_cast<off_t>(sizeof(buffer)), 0);
+            if (pread(fd, buffer, static_cast<size_t>(length - start), start) != length - start) {
+                ::close(fd);
+                return;
+            }
+            while (length > start && buffer[length - start - 1] == '\0') {
+                length--;
+            }
+            found = length > start;
+        }
+        
+        if (length < info.st_size && ftruncate(fd, length) != 0) {
+            std::cerr << "Failed to trim log file: " << path << std::endl;
+        }
+        ::close(fd);
+    }
+#endif
+}
+
+MappedLogFile::MappedLogFile()
+    : segmentSize(0),
+      sequence(0),
+      fd(-1),
+      mapping(nullptr),
+      offset(0),
+      fileSize(0),
+      reopenPending(false),
+      running(false) {
+}
+
+MappedLogFile::~MappedLogFile() {
+    close();
+}
+
+bool MappedLogFile::open(const std::string& dir, const LogRotationConfig& rotationConfig) {
+#ifdef ENGAIN_HAS_MMAP
+    if (mapping) return true;
+    
+    logDir = dir;
+    config = rotationConfig;
+    
+    // Segments are whole pages so msync can cover them exactly
+    size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    segmentSize = std::max(config.maxFileSize, pageSize);
+    segmentSize = (segmentSize + pageSize - 1) / pageSize * pageSize;
+    
+    std::filesystem::create_directories(logDir);
+    trimAbandonedFiles();
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!openSegment()) {
+            return false;
+        }
+    }
+    
+    running.store(true, std::memory_order_release);
+    syncThread = std::thread(&MappedLogFile::syncLoop, this);
+    return true;
+#else
+    (void)dir;
+    (void)rotationConfig;
+    return false;
+#endif
+}
+
+void MappedLogFile::close() {
+#ifdef ENGAIN_HAS_MMAP
+    bool wasRunning;
+    {
+        // Under the mutex, so the sync thread cannot miss the wakeup
+        std::lock_guard<std::mutex> lock(mutex);
+        wasRunning = running.exchange(false, std::memory_order_acq_rel);
+        syncWake.notify_one();
+    }
+    if (wasRunning) {
+        if (syncThread.joinable()) {
+            syncThread.join();
+        }
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const Segment& segment : retired) {
+        finishSegment(segment);
+    }
+    retired.clear();
+    
+    if (mapping) {
+        finishSegment(Segment{fd, mapping, segmentSize, offset});
+        fd = -1;
+        mapping = nullptr;
+        offset = 0;
+        fileSize = 0;
+    }
+    reopenPending = false;
+#endif
+}
+
+void MappedLogFile::write(const char* data, size_t length) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!mapping && !reopen()) return;
+    
+    // Start a new file rather than splitting a write that would fit in one
+    if (offset + length > segmentSize && length <= segmentSize) {
+        rotate();
+        if (!mapping && !reopen()) return;
+    }
+    
+    while (length > 0) {
+        if (offset == segmentSize) {
+            rotate();
+            if (!mapping && !reopen()) return;
+        }
+        
+        size_t chunk = std::min(length, segmentSize - offset);
+        if (offset + chunk > fileSize && !grow(offset + chunk)) return;
+        std::memcpy(mapping + offset, data, chunk);
+        offset += chunk;
+        data += chunk;
+        length -= chunk;
+    }
+}
+
+void MappedLogFile::flush() {
+#ifdef ENGAIN_HAS_MMAP
+    std::lock_guard<std::mutex> lock(mutex);
+    if (mapping && offset > 0) {
+        msync(mapping, offset, MS_ASYNC);
+    }
+#endif
+}
+
+bool MappedLogFile::openSegment() {
+#ifdef ENGAIN_HAS_MMAP
+    // Name each file after the time it was started and the process writing
+    // it; a name that is already taken is never reused
+    std::time_t now = std::time(nullptr);
+    std::tm* localTime = std::localtime(&now);
+    
+    std::string path;
+    int newFd = -1;
+    for (int attempt = 0; attempt < MAX_NAME_ATTEMPTS && newFd < 0; attempt++) {
+        std::ostringstream filename;
+        filename << logDir << "/engain_"
+                 << std::put_time(localTime, "%Y%m%d_%H%M%S")
+                 << "_p" << getpid()
+                 << "_" << std::setw(3) << std::setfill('0') << sequence++
+                 << ".log";
+        path = filename.str();
+        
+        newFd = ::open(path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+        if (newFd < 0 && errno != EEXIST) break;
+    }
+    if (newFd < 0) {
+        std::cerr << "Failed to open log file: " << path << std::endl;
+        return false;
+    }
+    
+    // Only the first step is allocated; the mapping covers the whole segment
+    // and write() extends the file ahead of the data
+    size_t initialSize = std::min(GROW_STEP, segmentSize);
+    if (ftruncate(newFd, static_cast<off_t>(initialSize)) != 0) {
+        std::cerr << "Failed to size log file: " << path << std::endl;
+        ::close(newFd);
+        ::unlink(path.c_str());
+        return false;
+    }
+    
+    void* newMapping = mmap(nullptr, segmentSize, PROT_READ | PROT_WRITE, MAP_SHARED, newFd, 0);
+    if (newMapping == MAP_FAILED) {
+        std::cerr << "Failed to map log file: " << path << std::endl;
+        ::close(newFd);
+        ::unlink(path.c_str());
+        return false;
+    }
+    
+    fd = newFd;
+    mapping = static_cast<char*>(newMapping);
+    offset = 0;
+    fileSize = initialSize;
+    currentPath = path;
+    ownFiles.push_back(path);
+    openedAt = std::chrono::steady_clock::now();
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool MappedLogFile::grow(size_t length) {
+#ifdef ENGAIN_HAS_MMAP
+    // Caller holds the mutex. Touching the mapping past the end of the file
+    // would fault, so the file always covers what has been written.
+    size_t newSize = std::min((length + GROW_STEP - 1) / GROW_STEP * GROW_STEP, segmentSize);
+    if (ftruncate(fd, static_cast<off_t>(newSize)) != 0) {
+        std::cerr << "Failed to extend log file: " << currentPath << std::endl;
+        return false;
+    }
+    fileSize = newSize;
+    return true;
+#else
+    (void)length;
+    return false;
+#endif
+}
+
+void MappedLogFile::rotate() {
+    // Caller holds the mutex. The full segment is handed to the sync thread
+    // so the msync and unmap stay off the calling thread.
+    retired.push_back(Segment{fd, mapping, segmentSize, offset});
+    fd = -1;
+    mapping = nullptr;
+    offset = 0;
+    fileSize = 0;
+    
+    if (!openSegment()) {
+        std::cerr << "Log rotation failed, log output is lost until a new file opens" << std::endl;
+        reopenPending = true;
+        nextReopen = std::chrono::steady_clock::now() + REOPEN_INTERVAL;
+    }
+    syncWake.notify_one();
+}
+
+bool MappedLogFile::reopen() {
+    // Caller holds the mutex
+    if (!reopenPending || std::chrono::steady_clock::now() < nextReopen) return false;
+    
+    if (!openSegment()) {
+        nextReopen = std::chrono::steady_clock::now() + REOPEN_INTERVAL;
+        return false;
+    }
+    reopenPending = false;
+    std::cerr << "Log output resumed in " << currentPath << std::endl;
+    return true;
+}
+
+void MappedLogFile::finishSegment(const Segment& segment) {
+#ifdef ENGAIN_HAS_MMAP
+    // Pages past the end of the file were never written
+    msync(segment.mapping, segment.used, MS_SYNC);
+    munmap(segment.mapping, segment.capacity);
+    
+    // Drop the unused, zero-filled end of the last step
+    if (ftruncate(segment.fd, static_cast<off_t>(segment.used)) != 0) {
+        std::cerr << "Failed to trim log file" << std::endl;
+    }
+    ::close(segment.fd);
+#else
+    (void)segment;
+#endif
+}
+
+void MappedLogFile::removeOldFiles() {
+    if (config.maxFiles <= 0) return;
+    
+    // Only files this instance created are pruned; other processes sharing
+    // the directory keep theirs. The current file is the newest, so it stays.
+    std::vector<std::string> expired;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        while (ownFiles.size() > static_cast<size_t>(config.maxFiles)) {
+            expired.push_back(ownFiles.front());
+            ownFiles.pop_front();
+        }
+    }
+    
+    std::error_code error;
+    for (const std::string& path : expired) {
+        std::filesystem::remove(path, error);
+    }
+}
+
+void MappedLogFile::trimAbandonedFiles() {
+#ifdef ENGAIN_HAS_MMAP
+    // A process killed before finishing its segment leaves it padded with
+    // zeros up to the last growth step. Live processes' files are left alone.
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(logDir, error)) {
+        std::string name = entry.path().filename().string();
+        if (!entry.is_regular_file() || name.rfind("engain_", 0) != 0 ||
+            entry.path().extension() != ".log") {
+            continue;
+        }
+        
+        long pid = ownerPid(name);
+        if (pid <= 0 || pid == static_cast<long>(getpid())) continue;
+        if (kill(static_cast<pid_t>(pid), 0) == 0 || errno != ESRCH) continue;
+        trimZeroTail(entry.path().string());
+    }
+#endif
+}
+
+void MappedLogFile::syncLoop() {
+#ifdef ENGAIN_HAS_MMAP
+    std::chrono::milliseconds interval(config.syncInterval > 0 ? config.syncInterval : 1000);
+    char* lastMapping = nullptr;
+    size_t lastSynced = 0;
+    
+    while (running.load(std::memory_order_acquire)) {
+        std::vector<Segment> finished;
+        char* syncMapping = nullptr;
+        size_t syncLength = 0;
+        
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            syncWake.wait_for(lock, interval, [this] {
+                return !running.load(std::memory_order_acquire) || !retired.empty();
+            });
+            
+            if (config.maxFileAge > 0 && mapping && offset > 0 &&
+                std::chrono::steady_clock::now() - openedAt >= std::chrono::seconds(config.maxFileAge)) {
+                rotate();
+            }
+            
+            finished.swap(retired);
+            syncMapping = mapping;
+            syncLength = offset;
+        }
+        
+        // Retired segments are only unmapped here, so syncing the current
+        // mapping outside the lock is safe even if it rotates meanwhile
+        if (syncMapping && (syncMapping != lastMapping || syncLength != lastSynced)) {
+            msync(syncMapping, syncLength, MS_SYNC);
+            lastMapping = syncMapping;
+            lastSynced = syncLength;
+        }
+        
+        if (!finished.empty()) {
+            for (const Segment& segment : finished) {
+                finishSegment(segment);
+            }
+            removeOldFiles();
+        }
+    }
+#endif
+}
+
+} // namespace ENGAIN
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ENGAIN {
+
+struct LogRotationConfig {
+    size_t maxFileSize;  // Bytes per file before rotating
+    int maxFileAge;      // Seconds per file before rotating, 0 for no limit
+    int maxFiles;        // Number of its own log files a process keeps
+    int syncInterval;    // Milliseconds between background syncs
+    
+    LogRotationConfig(size_t maxFileSize = 8 * 1024 * 1024, int maxFileAge = 0,
+                      int maxFiles = 5, int syncInterval = 1000)
+        : maxFileSize(maxFileSize), maxFileAge(maxFileAge),
+          maxFiles(maxFiles), syncInterval(syncInterval) {}
+};
+
+// Log file that appends into memory-mapped segments. Writes are a memcpy into
+// the page cache; a background thread syncs dirty pages, applies the age limit
+// and finishes rotated files. Only available on POSIX systems.
+//
+// Segment names carry the process id, so processes sharing a log directory
+// never write to or prune each other's files. Files grow in steps as they
+// fill, and zero tails left by a crashed process are trimmed by the next one.
+class MappedLogFile {
+public:
+    MappedLogFile();
+    ~MappedLogFile();
+    
+    bool open(const std::string& logDir, const LogRotationConfig& config);
+    void close();
+    bool isOpen() const { return mapping != nullptr; }
+    
+    void write(const char* data, size_t length);
+    // Schedule dirty pages for writeback without waiting
+    void flush();
+    
+    const std::string& getCurrentPath() const { return currentPath; }
+
+private:
+    MappedLogFile(const MappedLogFile&) = delete;
+    MappedLogFile& operator=(const MappedLogFile&) = delete;
+    
+    struct Segment {
+        int fd;
+        char* mapping;
+        size_t capacity;
+        size_t used;
+    };
+    
+    bool openSegment();
+    // Extend the current file so it covers at least length bytes
+    bool grow(size_t length);
+    void rotate();
+    // Retry a rotation whose new file could not be opened
+    bool reopen();
+    void finishSegment(const Segment& segment);
+    // Drop this instance's oldest files beyond maxFiles
+    void removeOldFiles();
+    // Cut the zero padding off segments whose process has exited
+    void trimAbandonedFiles();
+    void syncLoop();
+    
+    std::string logDir;
+    LogRotationConfig config;
+    size_t segmentSize;
+    unsigned int sequence;
+    
+    // Current segment, guarded by mutex
+    std::mutex mutex;
+    int fd;
+    char* mapping;
+    size_t offset;
+    size_t fileSize;
+    std::string currentPath;
+    std::chrono::steady_clock::time_point openedAt;
+    bool reopenPending;
+    std::chrono::steady_clock::time_point nextReopen;
+    // Files this instance created, oldest first
+    std::deque<std::string> ownFiles;
+    
+    // Rotated segments waiting for the sync thread to finish them
+    std::vector<Segment> retired;
+    
+    std::thread syncThread;
+    std::condition_variable syncWake;
+    std::atomic<bool> running;
+};
+
+} // namespace ENGAIN
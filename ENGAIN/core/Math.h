@@ -34,6 +34,14 @@ struct Vector2 {
     }
 };
 
+inline float lerp(float a, float b, float t) {
+    return a + (b - a) * t;
+}
+
+inline Vector2 lerp(const Vector2& a, const Vector2& b, float t) {
+    return Vector2(lerp(a.x, b.x, t), lerp(a.y, b.y, t));
+}
+
 struct Rectangle {
     float x, y, width, height;
     
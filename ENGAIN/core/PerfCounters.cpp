@@ -0,0 +1,265 @@
+#include "PerfCounters.h"
+#include "Logger.h"
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+
+#ifdef __linux__
+#define ENGAIN_HAS_PERF_EVENTS 1
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace ENGAIN {
+
+std::atomic<bool> PerfCounters::trackScopes(false);
+
+namespace {
+    const int EVENT_COUNT = static_cast<int>(PerfEvent::COUNT);
+    
+    const char* EVENT_NAMES[EVENT_COUNT] = {
+        "cycles", "instructions", "L1d misses", "LLC misses", "branch misses"
+    };
+
+#ifdef ENGAIN_HAS_PERF_EVENTS
+    void describeEvent(PerfEvent event, perf_event_attr& attr) {
+        switch (event) {
+            case PerfEvent::CYCLES:
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_CPU_CYCLES;
+                break;
+            case PerfEvent::INSTRUCTIONS:
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+                break;
+            case PerfEvent::L1D_MISSES:
+                attr.type = PERF_TYPE_HW_CACHE;
+                attr.config = PERF_COUNT_HW_CACHE_L1D |
+                              (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                              (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+                break;
+            case PerfEvent::LLC_MISSES:
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_CACHE_MISSES;
+                break;
+            case PerfEvent::BRANCH_MISSES:
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+                break;
+            default:
+                break;
+        }
+    }
+    
+    int readParanoidLevel() {
+        std::ifstream file("/proc/sys/kernel/perf_event_paranoid");
+        int level = 0;
+        return file >> level ? level : -1;
+    }
+#endif
+}
+
+double PerfCounterValues::getIPC() const {
+    uint64_t cycles = (*this)[PerfEvent::CYCLES];
+    return cycles > 0 ? static_cast<double>((*this)[PerfEvent::INSTRUCTIONS]) / cycles : 0.0;
+}
+
+PerfCounterValues PerfCounterValues::operator-(const PerfCounterValues& other) const {
+    PerfCounterValues result;
+    for (int i = 0; i < EVENT_COUNT; i++) {
+        // Scaled multiplexed counts can step back slightly; clamp at zero
+        result.counts[i] = counts[i] > other.counts[i] ? counts[i] - other.counts[i] : 0;
+    }
+    return result;
+}
+
+PerfCounterValues& PerfCounterValues::operator+=(const PerfCounterValues& other) {
+    for (int i = 0; i < EVENT_COUNT; i++) {
+        counts[i] += other.counts[i];
+    }
+    return *this;
+}
+
+PerfCounterValues PerfCounterValues::operator/(uint64_t divisor) const {
+    PerfCounterValues result;
+    if (divisor == 0) return result;
+    for (int i = 0; i < EVENT_COUNT; i++) {
+        result.counts[i] = counts[i] / divisor;
+    }
+    return result;
+}
+
+PerfCounters::PerfCounters()
+    : leaderFd(-1),
+      groupSize(0) {
+    for (int i = 0; i < EVENT_COUNT; i++) {
+        fds[i] = -1;
+        groupIndex[i] = -1;
+    }
+}
+
+PerfCounters::~PerfCounters() {
+    close();
+}
+
+bool PerfCounters::open() {
+#ifdef ENGAIN_HAS_PERF_EVENTS
+    if (isOpen()) return true;
+    
+    int firstError = 0;
+    for (int i = 0; i < EVENT_COUNT; i++) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        describeEvent(static_cast<PerfEvent>(i), attr);
+        attr.disabled = leaderFd < 0 ? 1 : 0;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED |
+                           PERF_FORMAT_TOTAL_TIME_RUNNING;
+        
+        // This thread, any CPU
+        int fd = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, leaderFd, 0));
+        if (fd < 0) {
+            if (firstError == 0) firstError = errno;
+            continue;
+        }
+        
+        fds[i] = fd;
+        groupIndex[i] = groupSize++;
+        if (leaderFd < 0) leaderFd = fd;
+    }
+    
+    if (leaderFd < 0) {
+        ENGAIN_LOG_WARNING(TIME, "Hardware performance counters unavailable: " << std::strerror(firstError)
+                           << " (perf_event_paranoid is " << readParanoidLevel() << ")");
+        return false;
+    }
+    
+    ioctl(leaderFd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(leaderFd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    
+    std::ostringstream missing;
+    for (int i = 0; i < EVENT_COUNT; i++) {
+        if (groupIndex[i] < 0) {
+            missing << (missing.tellp() > 0 ? ", " : "") << EVENT_NAMES[i];
+        }
+    }
+    if (missing.tellp() > 0) {
+        ENGAIN_LOG_INFO(TIME, "Hardware performance counters enabled without " << missing.str());
+    } else {
+        ENGAIN_LOG_INFO(TIME, "Hardware performance counters enabled");
+    }
+    return true;
+#else
+    ENGAIN_LOG_WARNING(TIME, "Hardware performance counters are only available on Linux");
+    return false;
+#endif
+}
+
+void PerfCounters::close() {
+#ifdef ENGAIN_HAS_PERF_EVENTS
+    for (int i = 0; i < EVENT_COUNT; i++) {
+        if (fds[i] >= 0) {
+            ::close(fds[i]);
+        }
+        fds[i] = -1;
+        groupIndex[i] = -1;
+    }
+#endif
+    leaderFd = -1;
+    groupSize = 0;
+}
+
+bool PerfCounters::read(PerfCounterValues& values) {
+#ifdef ENGAIN_HAS_PERF_EVENTS
+    if (leaderFd < 0) return false;
+    
+    // { nr, time_enabled, time_running, value[nr] }
+    uint64_t data[3 + EVENT_COUNT];
+    ssize_t size = ::read(leaderFd, data, sizeof(data));
+    if (size < static_cast<ssize_t>(3 * sizeof(uint64_t)) || data[2] == 0) {
+        return false;
+    }
+    
+    double scale = static_cast<double>(data[1]) / data[2];
+    for (int i = 0; i < EVENT_COUNT; i++) {
+        int index = groupIndex[i];
+        values.counts[i] = index >= 0 && static_cast<uint64_t>(index) < data[0]
+                         ? static_cast<uint64_t>(data[3 + index] * scale) : 0;
+    }
+    return true;
+#else
+    (void)values;
+    return false;
+#endif
+}
+
+bool PerfCounters::initialize() {
+    const char* value = std::getenv("ENGAIN_PERF_COUNTERS");
+    if (!value || !*value || std::strcmp(value, "0") == 0) return false;
+    
+    if (std::strcmp(value, "scopes") == 0) {
+        setScopeTracking(true);
+    }
+    return true;
+}
+
+PerfCounters* PerfCounters::forCurrentThread() {
+    // Opened once per thread; a failed open is not retried
+    thread_local std::unique_ptr<PerfCounters> counters;
+    thread_local bool attempted = false;
+    if (!attempted) {
+        attempted = true;
+        counters.reset(new PerfCounters());
+        if (!counters->open()) {
+            counters.reset();
+        }
+    }
+    return counters.get();
+}
+
+const char* PerfCounters::getEventName(PerfEvent event) {
+    int index = static_cast<int>(event);
+    return index >= 0 && index < EVENT_COUNT ? EVENT_NAMES[index] : "unknown";
+}
+
+void PerfCounters::setScopeTracking(bool enabled) {
+    trackScopes.store(enabled, std::memory_order_relaxed);
+}
+
+void PerfCounters::addScopeSample(const char* name, const PerfCounterValues& delta) {
+    // Few distinct scopes per thread, so a linear search beats hashing
+    for (ScopeTotals& scope : scopes) {
+        if (scope.name == name) {
+            scope.calls++;
+            scope.totals += delta;
+            return;
+        }
+    }
+    scopes.push_back(ScopeTotals{name, 1, delta});
+}
+
+void PerfCounters::logScopeReport() const {
+    for (const ScopeTotals& scope : scopes) {
+        PerfCounterValues average = scope.totals / scope.calls;
+        std::ostringstream line;
+        line << std::fixed << std::setprecision(2) << scope.name << ": " << scope.calls
+             << " calls, per call " << average[PerfEvent::CYCLES] << " cycles, IPC "
+             << average.getIPC();
+        for (int i = static_cast<int>(PerfEvent::L1D_MISSES); i < EVENT_COUNT; i++) {
+            if (groupIndex[i] >= 0) {
+                line << ", " << average.counts[i] << " " << EVENT_NAMES[i];
+            }
+        }
+        ENGAIN_LOG_INFO(TIME, line.str());
+    }
+}
+
+} // namespace ENGAIN
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "Profiler.h"
+
+namespace ENGAIN {
+
+enum class PerfEvent {
+    CYCLES,
+    INSTRUCTIONS,
+    L1D_MISSES,     // L1 data cache read misses
+    LLC_MISSES,     // Last level cache misses
+    BRANCH_MISSES,
+    COUNT
+};
+
+struct PerfCounterValues {
+    uint64_t counts[static_cast<int>(PerfEvent::COUNT)];
+    
+    PerfCounterValues() : counts() {}
+    
+    uint64_t operator[](PerfEvent event) const { return counts[static_cast<int>(event)]; }
+    uint64_t& operator[](PerfEvent event) { return counts[static_cast<int>(event)]; }
+    
+    // Instructions per cycle, 0 when cycles were not counted
+    double getIPC() const;
+    
+    PerfCounterValues operator-(const PerfCounterValues& other) const;
+    PerfCounterValues& operator+=(const PerfCounterValues& other);
+    PerfCounterValues operator/(uint64_t divisor) const;
+};
+
+// Hardware counters for the calling thread through Linux perf_event_open.
+// All events are read with one read() call as a group; events the CPU or
+// kernel does not offer are skipped, and if none can be opened (no PMU in a
+// VM, perf_event_paranoid too strict) open() fails and callers carry on
+// without counters. Only user-space work is counted.
+class PerfCounters {
+public:
+    PerfCounters();
+    ~PerfCounters();
+    
+    bool open();
+    void close();
+    bool isOpen() const { return leaderFd >= 0; }
+    bool isAvailable(PerfEvent event) const { return groupIndex[static_cast<int>(event)] >= 0; }
+    
+    // Totals since open(), scaled up when the kernel had to multiplex them
+    bool read(PerfCounterValues& values);
+    
+    // Returns true if ENGAIN_PERF_COUNTERS asks for counters; the value
+    // "scopes" also turns on scope tracking
+    static bool initialize();
+    // Counters for the calling thread, opened on first use; null when unavailable
+    static PerfCounters* forCurrentThread();
+    static const char* getEventName(PerfEvent event);
+    
+    // ENGAIN_PERF_SCOPE reads the counters on entry and exit while this is on
+    static void setScopeTracking(bool enabled);
+    static bool isTrackingScopes() { return trackScopes.load(std::memory_order_relaxed); }
+    
+    void addScopeSample(const char* name, const PerfCounterValues& delta);
+    // Log per-call averages for every tracked scope on this thread
+    void logScopeReport() const;
+
+private:
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+    
+    struct ScopeTotals {
+        const char* name;
+        uint64_t calls;
+        PerfCounterValues totals;
+    };
+    
+    static std::atomic<bool> trackScopes;
+    
+    int leaderFd;
+    int fds[static_cast<int>(PerfEvent::COUNT)];
+    // Position of each event in the group read, -1 when it is not counted
+    int groupIndex[static_cast<int>(PerfEvent::COUNT)];
+    int groupSize;
+    
+    std::vector<ScopeTotals> scopes;
+};
+
+// Adds the counter deltas of the enclosing scope to the thread's totals
+class PerfScope {
+public:
+    explicit PerfScope(const char* name)
+        : name(name),
+          counters(PerfCounters::isTrackingScopes() ? PerfCounters::forCurrentThread() : nullptr) {
+        if (counters && !counters->read(start)) {
+            counters = nullptr;
+        }
+    }
+    
+    ~PerfScope() {
+        PerfCounterValues end;
+        if (counters && counters->read(end)) {
+            counters->addScopeSample(name, end - start);
+        }
+    }
+
+private:
+    PerfScope(const PerfScope&) = delete;
+    PerfScope& operator=(const PerfScope&) = delete;
+    
+    const char* name;
+    PerfCounters* counters;
+    PerfCounterValues start;
+};
+
+} // namespace ENGAIN
+
+// A profiler scope that also collects hardware counters when scope tracking
+// is on. Reading the counters is a system call, so keep these coarse.
+#if ENGAIN_PROFILER_ENABLED
+#define ENGAIN_PERF_SCOPE(name) \
+    ENGAIN_PROFILE_SCOPE(name); \
+    ::ENGAIN::PerfScope ENGAIN_PROFILE_CONCAT(engainPerfScope_, __LINE__)(name)
+#else
+#define ENGAIN_PERF_SCOPE(name) ((void)0)
+#endif
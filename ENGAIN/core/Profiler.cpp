@@ -0,0 +1,260 @@
+#include "Profiler.h"
+#include "Logger.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+namespace ENGAIN {
+
+std::atomic<bool> Profiler::recording(false);
+std::atomic<bool> Profiler::wrapping(false);
+std::atomic<unsigned int> Profiler::generation(1);
+thread_local Profiler::ThreadBuffer* Profiler::threadBuffer = nullptr;
+
+namespace {
+    void writeJsonString(FILE* file, const char* text) {
+        fputc('"', file);
+        for (const char* c = text; *c; c++) {
+            if (*c == '"' || *c == '\\') {
+                fputc('\\', file);
+                fputc(*c, file);
+            } else if (static_cast<unsigned char>(*c) < 0x20) {
+                fprintf(file, "\\u%04x", static_cast<unsigned char>(*c));
+            } else {
+                fputc(*c, file);
+            }
+        }
+        fputc('"', file);
+    }
+    
+    size_t roundUpToPowerOfTwo(size_t value) {
+        size_t result = 1;
+        while (result < value) result <<= 1;
+        return result;
+    }
+}
+
+Profiler& Profiler::getInstance() {
+    static Profiler instance;
+    return instance;
+}
+
+Profiler::Profiler()
+    : maxEventsPerThread(1 << 18),
+      sessionStart(0) {
+}
+
+Profiler::~Profiler() {
+    shutdown();
+}
+
+void Profiler::initialize() {
+    if (const char* events = std::getenv("ENGAIN_PROFILE_EVENTS")) {
+        long value = std::strtol(events, nullptr, 10);
+        if (value > 0) {
+            setMaxEventsPerThread(static_cast<size_t>(value));
+        }
+    }
+    
+    if (const char* path = std::getenv("ENGAIN_PROFILE")) {
+        start(*path ? path : "trace.json");
+    }
+}
+
+void Profiler::start(const std::string& path) {
+    startSession(path, false);
+}
+
+void Profiler::startContinuous() {
+    startSession("", true);
+}
+
+void Profiler::startSession(const std::string& path, bool continuous) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (recording.load(std::memory_order_relaxed)) return;
+    
+    outputPath = path;
+    sessionStart = now();
+    wrapping.store(continuous, std::memory_order_relaxed);
+    
+    // Threads notice the new generation and clear their buffers themselves
+    generation.fetch_add(1, std::memory_order_acq_rel);
+    recording.store(true, std::memory_order_release);
+    
+    if (continuous) {
+        ENGAIN_LOG_INFO(GENERAL, "Profiler recording continuously, keeping the last "
+                        << roundUpToPowerOfTwo(maxEventsPerThread) << " events per thread");
+    } else {
+        ENGAIN_LOG_INFO(GENERAL, "Profiler started, trace will be written to " << outputPath);
+    }
+}
+
+void Profiler::stop() {
+    if (!recording.exchange(false, std::memory_order_acq_rel)) return;
+    
+    if (!outputPath.empty()) {
+        writeChromeTrace(outputPath);
+    }
+}
+
+void Profiler::shutdown() {
+    stop();
+}
+
+void Profiler::setMaxEventsPerThread(size_t maxEvents) {
+    std::lock_guard<std::mutex> lock(mutex);
+    maxEventsPerThread = maxEvents > 0 ? maxEvents : 1;
+}
+
+void Profiler::setThreadName(const std::string& name) {
+    ThreadBuffer* buffer = acquireThreadBuffer();
+    std::lock_guard<std::mutex> lock(mutex);
+    buffer->threadName = name;
+}
+
+Profiler::ThreadBuffer* Profiler::acquireThreadBuffer() {
+    std::lock_guard<std::mutex> lock(mutex);
+    
+    ThreadBuffer* buffer = threadBuffer;
+    if (!buffer) {
+        buffers.push_back(std::unique_ptr<ThreadBuffer>(new ThreadBuffer()));
+        buffer = buffers.back().get();
+        buffer->capacity = 0;
+        buffer->count.store(0, std::memory_order_relaxed);
+        buffer->dropped.store(0, std::memory_order_relaxed);
+        buffer->generation = 0;
+        buffer->threadIndex = static_cast<unsigned int>(buffers.size());
+        threadBuffer = buffer;
+    }
+    
+    unsigned int current = generation.load(std::memory_order_acquire);
+    if (buffer->generation != current) {
+        // Power-of-two capacity so wrapping is a mask, not a division
+        size_t capacity = roundUpToPowerOfTwo(maxEventsPerThread);
+        if (!buffer->events || buffer->capacity != capacity) {
+            buffer->events.reset(new EventSlot[capacity]);
+            buffer->capacity = capacity;
+        }
+        buffer->count.store(0, std::memory_order_relaxed);
+        buffer->dropped.store(0, std::memory_order_relaxed);
+        buffer->generation = current;
+    }
+    return buffer;
+}
+
+bool Profiler::writeChromeTrace(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex);
+    
+    FILE* file = std::fopen(path.c_str(), "w");
+    if (!file) {
+        ENGAIN_LOG_ERROR(GENERAL, "Failed to open profiler trace: " << path);
+        return false;
+    }
+    
+    unsigned int current = generation.load(std::memory_order_acquire);
+    uint64_t dropped = 0;
+    bool first = true;
+    
+    fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", file);
+    for (const auto& buffer : buffers) {
+        if (buffer->generation != current) continue;
+        
+        dropped += buffer->dropped.load(std::memory_order_relaxed);
+        if (buffer->threadName.empty()) continue;
+        
+        fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":",
+                first ? "" : ",\n", buffer->threadIndex);
+        writeJsonString(file, buffer->threadName.c_str());
+        fputs("}}", file);
+        first = false;
+    }
+    
+    std::vector<ProfileEvent> events;
+    collectEventsLocked(INT64_MIN, events);
+    for (const ProfileEvent& event : events) {
+        fputs(first ? "{\"name\":" : ",\n{\"name\":", file);
+        writeJsonString(file, event.name);
+        fprintf(file, ",\"cat\":\"engain\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                event.threadIndex, (event.start - sessionStart) / 1000.0, event.duration / 1000.0);
+        first = false;
+    }
+    size_t written = events.size();
+    fputs("\n]}\n", file);
+    std::fclose(file);
+    
+    if (dropped > 0) {
+        ENGAIN_LOG_WARNING(GENERAL, "Profiler buffers were full, " << dropped << " events dropped");
+    }
+    ENGAIN_LOG_INFO(GENERAL, "Wrote " << written << " profiler events to " << path);
+    return true;
+}
+
+void Profiler::collectEvents(int64_t since, std::vector<ProfileEvent>& out) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    collectEventsLocked(since, out);
+}
+
+void Profiler::collectEventsLocked(int64_t since, std::vector<ProfileEvent>& out) const {
+    unsigned int current = generation.load(std::memory_order_acquire);
+    bool wrapped = wrapping.load(std::memory_order_relaxed);
+    size_t initial = out.size();
+    
+    for (const auto& buffer : buffers) {
+        if (buffer->generation != current) continue;
+        
+        size_t count = buffer->count.load(std::memory_order_acquire);
+        size_t first = wrapped && count > buffer->capacity ? count - buffer->capacity : 0;
+        size_t copied = out.size();
+        
+        for (size_t i = first; i < count; i++) {
+            const EventSlot& slot = buffer->events[i & (buffer->capacity - 1)];
+            ProfileEvent event;
+            event.name = slot.name.load(std::memory_order_relaxed);
+            event.start = slot.start.load(std::memory_order_relaxed);
+            event.duration = slot.duration.load(std::memory_order_relaxed);
+            event.threadIndex = buffer->threadIndex;
+            out.push_back(event);
+        }
+        
+        if (!wrapped) continue;
+        
+        // The owner may have lapped us while we copied; slots older than
+        // its current window can hold newer events and are thrown away
+        std::atomic_thread_fence(std::memory_order_acquire);
+        size_t after = buffer->count.load(std::memory_order_relaxed);
+        size_t valid = after > buffer->capacity ? after - buffer->capacity : 0;
+        if (valid > first) {
+            size_t stale = std::min(valid - first, out.size() - copied);
+            out.erase(out.begin() + copied, out.begin() + copied + stale);
+        }
+    }
+    
+    // Keep events that ended inside the requested window
+    out.erase(std::remove_if(out.begin() + initial, out.end(), [since](const ProfileEvent& event) {
+        return event.start + event.duration < since;
+    }), out.end());
+}
+
+std::string Profiler::getThreadName(unsigned int threadIndex) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& buffer : buffers) {
+        if (buffer->threadIndex == threadIndex) {
+            return buffer->threadName;
+        }
+    }
+    return std::string();
+}
+
+uint64_t Profiler::getDroppedCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    uint64_t dropped = 0;
+    unsigned int current = generation.load(std::memory_order_acquire);
+    for (const auto& buffer : buffers) {
+        if (buffer->generation == current) {
+            dropped += buffer->dropped.load(std::memory_order_relaxed);
+        }
+    }
+    return dropped;
+}
+
+} // namespace ENGAIN
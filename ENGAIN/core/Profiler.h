@@ -0,0 +1,160 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#ifndef ENGAIN_PROFILER_ENABLED
+#define ENGAIN_PROFILER_ENABLED 1
+#endif
+
+namespace ENGAIN {
+
+struct ProfileEvent {
+    const char* name;
+    int64_t start;     // Nanoseconds on the steady clock
+    int64_t duration;
+    unsigned int threadIndex;
+};
+
+// Records timed scopes into per-thread buffers and writes them out as
+// Chrome Trace Event JSON (chrome://tracing, ui.perfetto.dev). Recording a
+// scope is two clock reads and a store into a thread-owned buffer; scope
+// names must be string literals or otherwise outlive the session.
+class Profiler {
+public:
+    static Profiler& getInstance();
+    
+    // Starts a session if ENGAIN_PROFILE is set, using its value as the
+    // trace file name. ENGAIN_PROFILE_EVENTS sets the per-thread capacity.
+    void initialize();
+    
+    // Begin recording; the trace is written to outputPath on stop()
+    void start(const std::string& outputPath = "trace.json");
+    // Record indefinitely, keeping only the most recent events per thread.
+    // Used by the flight recorder; nothing is written on stop().
+    void startContinuous();
+    void stop();
+    void shutdown();
+    
+    static bool isRecording() { return recording.load(std::memory_order_relaxed); }
+    
+    // Events each thread can record per session, set before start()
+    void setMaxEventsPerThread(size_t maxEvents);
+    // Name shown for the calling thread in the trace viewer
+    void setThreadName(const std::string& name);
+    
+    bool writeChromeTrace(const std::string& path);
+    uint64_t getDroppedCount() const;
+    
+    // Copy out events that ended at or after since (steady clock ns)
+    void collectEvents(int64_t since, std::vector<ProfileEvent>& out) const;
+    std::string getThreadName(unsigned int threadIndex) const;
+    
+    static int64_t now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+    
+    static void record(const char* name, int64_t start, int64_t end) {
+        ThreadBuffer* buffer = threadBuffer;
+        if (!buffer || buffer->generation != generation.load(std::memory_order_acquire)) {
+            buffer = getInstance().acquireThreadBuffer();
+            if (!buffer) return;
+        }
+        
+        size_t index = buffer->count.load(std::memory_order_relaxed);
+        if (index >= buffer->capacity && !wrapping.load(std::memory_order_relaxed)) {
+            buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        
+        EventSlot& slot = buffer->events[index & (buffer->capacity - 1)];
+        slot.name.store(name, std::memory_order_relaxed);
+        slot.start.store(start, std::memory_order_relaxed);
+        slot.duration.store(end - start, std::memory_order_relaxed);
+        buffer->count.store(index + 1, std::memory_order_release);
+    }
+
+private:
+    Profiler();
+    ~Profiler();
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+    
+    // Fields are atomic so other threads can copy slots while the owner
+    // keeps writing; relaxed stores cost the same as plain ones
+    struct EventSlot {
+        std::atomic<const char*> name;
+        std::atomic<int64_t> start;
+        std::atomic<int64_t> duration;
+    };
+    
+    // Written only by its owning thread; count is the number of events
+    // ever recorded, and slots wrap when the profiler is continuous
+    struct ThreadBuffer {
+        std::unique_ptr<EventSlot[]> events;
+        size_t capacity;
+        std::atomic<size_t> count;
+        std::atomic<uint64_t> dropped;
+        unsigned int generation;
+        unsigned int threadIndex;
+        std::string threadName;
+    };
+    
+    ThreadBuffer* acquireThreadBuffer();
+    void collectEventsLocked(int64_t since, std::vector<ProfileEvent>& out) const;
+    
+    void startSession(const std::string& path, bool continuous);
+    
+    static std::atomic<bool> recording;
+    static std::atomic<bool> wrapping;
+    static std::atomic<unsigned int> generation;
+    static thread_local ThreadBuffer* threadBuffer;
+    
+    mutable std::mutex mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    size_t maxEventsPerThread;
+    int64_t sessionStart;
+    std::string outputPath;
+};
+
+// Times the enclosing scope while a profiling session is running
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* name)
+        : name(Profiler::isRecording() ? name : nullptr),
+          start(this->name ? Profiler::now() : 0) {}
+    
+    ~ProfileScope() {
+        if (name) {
+            Profiler::record(name, start, Profiler::now());
+        }
+    }
+
+private:
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+    
+    const char* name;
+    int64_t start;
+};
+
+} // namespace ENGAIN
+
+#define ENGAIN_PROFILE_CONCAT_(a, b) a##b
+#define ENGAIN_PROFILE_CONCAT(a, b) ENGAIN_PROFILE_CONCAT_(a, b)
+
+// Profiling instrumentation, compiled out when ENGAIN_PROFILER_ENABLED is 0
+#if ENGAIN_PROFILER_ENABLED
+#define ENGAIN_PROFILE_SCOPE(name) \
+    ::ENGAIN::ProfileScope ENGAIN_PROFILE_CONCAT(engainProfileScope_, __LINE__)(name)
+#define ENGAIN_PROFILE_FUNCTION() ENGAIN_PROFILE_SCOPE(__func__)
+#else
+#define ENGAIN_PROFILE_SCOPE(name) ((void)0)
+#define ENGAIN_PROFILE_FUNCTION() ((void)0)
+#endif
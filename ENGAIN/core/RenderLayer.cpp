@@ -0,0 +1,170 @@
+#include "RenderLayer.h"
+#include "Window.h"
+#include "Logger.h"
+#include "Profiler.h"
+#include <algorithm>
+
+namespace ENGAIN {
+
+RenderLayer::RenderLayer(const std::string& name, int zOrder, DrawFunction draw)
+    : name(name),
+      zOrder(zOrder),
+      draw(std::move(draw)),
+      opaque(false),
+      dirty(true),
+      uncached(false),
+      textureRenderer(nullptr),
+      texture(nullptr),
+      textureWidth(0),
+      textureHeight(0),
+      rebuildCount(0) {
+}
+
+RenderLayer::~RenderLayer() {
+    release();
+}
+
+void RenderLayer::setDrawFunction(DrawFunction newDraw) {
+    draw = std::move(newDraw);
+    dirty = true;
+}
+
+void RenderLayer::setOpaque(bool isOpaque) {
+    opaque = isOpaque;
+    if (texture) {
+        SDL_SetTextureBlendMode(texture, opaque ? SDL_BLENDMODE_NONE : SDL_BLENDMODE_BLEND);
+    }
+}
+
+void RenderLayer::release() {
+    if (texture) {
+        SDL_DestroyTexture(texture);
+        texture = nullptr;
+    }
+    textureRenderer = nullptr;
+    dirty = true;
+}
+
+void RenderLayer::render(SDL_Renderer* renderer, int width, int height) {
+    if (!draw || !renderer) return;
+    
+    if (uncached) {
+        draw(renderer);
+        return;
+    }
+    
+    if (dirty || renderer != textureRenderer || width != textureWidth || height != textureHeight) {
+        if (!rebuild(renderer, width, height)) {
+            draw(renderer);
+            return;
+        }
+    }
+    
+    SDL_Rect destination = {0, 0, textureWidth, textureHeight};
+    SDL_RenderCopy(renderer, texture, nullptr, &destination);
+}
+
+bool RenderLayer::rebuild(SDL_Renderer* renderer, int width, int height) {
+    ENGAIN_PROFILE_SCOPE("RenderLayer::rebuild");
+    
+    if (!texture || renderer != textureRenderer || width != textureWidth || height != textureHeight) {
+        release();
+        if (!SDL_RenderTargetSupported(renderer)) {
+            ENGAIN_LOG_WARNING(RENDER, "Render targets unsupported, layer '" << name << "' is drawn every frame");
+            uncached = true;
+            return false;
+        }
+        
+        texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, width, height);
+        if (!texture) {
+            ENGAIN_LOG_WARNING(RENDER, "Layer '" << name << "' texture creation failed: " << SDL_GetError()
+                               << " - drawing it every frame");
+            uncached = true;
+            return false;
+        }
+        SDL_SetTextureBlendMode(texture, opaque ? SDL_BLENDMODE_NONE : SDL_BLENDMODE_BLEND);
+        textureRenderer = renderer;
+        textureWidth = width;
+        textureHeight = height;
+    }
+    
+    SDL_Texture* previousTarget = SDL_GetRenderTarget(renderer);
+    if (SDL_SetRenderTarget(renderer, texture) != 0) {
+        ENGAIN_LOG_WARNING(RENDER, "Drawing into layer '" << name << "' failed: " << SDL_GetError());
+        release();
+        uncached = true;
+        return false;
+    }
+    
+    // Start from transparent so only what the layer draws covers the scene
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+    SDL_RenderClear(renderer);
+    draw(renderer);
+    SDL_SetRenderTarget(renderer, previousTarget);
+    
+    dirty = false;
+    rebuildCount++;
+    ENGAIN_LOG_DEBUG(RENDER, "Layer '" << name << "' cached at " << width << "x" << height);
+    return true;
+}
+
+LayerStack::LayerStack(Window& window)
+    : window(window) {
+    // Target textures lose their contents when the device is reset
+    EventDispatcher& events = EventDispatcher::getInstance();
+    eventListeners.push_back(events.subscribe(SDL_RENDER_TARGETS_RESET, [this](const SDL_Event&) {
+        invalidateAll();
+    }));
+    eventListeners.push_back(events.subscribe(SDL_RENDER_DEVICE_RESET, [this](const SDL_Event&) {
+        for (auto& layer : layers) {
+            layer->release();
+        }
+    }));
+}
+
+LayerStack::~LayerStack() {
+    for (EventListenerId id : eventListeners) {
+        EventDispatcher::getInstance().unsubscribe(id);
+    }
+}
+
+RenderLayer& LayerStack::addLayer(const std::string& name, int zOrder, RenderLayer::DrawFunction draw) {
+    auto position = std::upper_bound(layers.begin(), layers.end(), zOrder,
+                                     [](int z, const std::unique_ptr<RenderLayer>& layer) {
+                                         return z < layer->getZOrder();
+                                     });
+    position = layers.insert(position, std::unique_ptr<RenderLayer>(new RenderLayer(name, zOrder, std::move(draw))));
+    return **position;
+}
+
+RenderLayer* LayerStack::getLayer(const std::string& name) {
+    for (auto& layer : layers) {
+        if (layer->getName() == name) return layer.get();
+    }
+    return nullptr;
+}
+
+void LayerStack::removeLayer(const std::string& name) {
+    layers.erase(std::remove_if(layers.begin(), layers.end(),
+                                [&name](const std::unique_ptr<RenderLayer>& layer) {
+                                    return layer->getName() == name;
+                                }),
+                 layers.end());
+}
+
+void LayerStack::invalidateAll() {
+    for (auto& layer : layers) {
+        layer->invalidate();
+    }
+}
+
+void LayerStack::render(int fromZ, int toZ) {
+    ENGAIN_PROFILE_SCOPE("LayerStack::render");
+    for (auto& layer : layers) {
+        if (layer->getZOrder() < fromZ) continue;
+        if (layer->getZOrder() > toZ) break;
+        layer->render(window.getRenderer(), window.getWidth(), window.getHeight());
+    }
+}
+
+} // namespace ENGAIN
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <climits>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "EventDispatcher.h"
+
+namespace ENGAIN {
+
+class Window;
+
+// Static content drawn once into a target texture and copied to the screen
+// every frame after that. The cache is rebuilt when the layer is
+// invalidated, its draw function changes or the output size changes.
+class RenderLayer {
+public:
+    using DrawFunction = std::function<void(SDL_Renderer*)>;
+    
+    RenderLayer(const std::string& name, int zOrder, DrawFunction draw);
+    ~RenderLayer();
+    
+    // Contents changed; redraw on the next render()
+    void invalidate() { dirty = true; }
+    void setDrawFunction(DrawFunction newDraw);
+    // Opaque layers cover the whole screen and are copied without blending
+    void setOpaque(bool isOpaque);
+    // Drop the cached texture, e.g. after the render device was lost
+    void release();
+    
+    // Rebuild the cache if it is stale, then copy it to the current target
+    void render(SDL_Renderer* renderer, int width, int height);
+    
+    const std::string& getName() const { return name; }
+    int getZOrder() const { return zOrder; }
+    bool isCached() const { return texture && !dirty; }
+    // Times the cache was redrawn
+    unsigned int getRebuildCount() const { return rebuildCount; }
+
+private:
+    RenderLayer(const RenderLayer&) = delete;
+    RenderLayer& operator=(const RenderLayer&) = delete;
+    
+    bool rebuild(SDL_Renderer* renderer, int width, int height);
+    
+    std::string name;
+    int zOrder;
+    DrawFunction draw;
+    bool opaque;
+    bool dirty;
+    // Set when render targets are unavailable; the layer is then drawn
+    // directly every frame
+    bool uncached;
+    
+    SDL_Renderer* textureRenderer;
+    SDL_Texture* texture;
+    int textureWidth;
+    int textureHeight;
+    unsigned int rebuildCount;
+};
+
+// The cached layers of a window, composited in z-order
+class LayerStack {
+public:
+    explicit LayerStack(Window& window);
+    ~LayerStack();
+    
+    // Layers with equal z-order are drawn in the order they were added
+    RenderLayer& addLayer(const std::string& name, int zOrder, RenderLayer::DrawFunction draw);
+    RenderLayer* getLayer(const std::string& name);
+    void removeLayer(const std::string& name);
+    void invalidateAll();
+    
+    // Composite the layers with fromZ <= z-order <= toZ, so dynamic content
+    // can be drawn between background and foreground layers
+    void render(int fromZ = INT_MIN, int toZ = INT_MAX);
+
+private:
+    LayerStack(const LayerStack&) = delete;
+    LayerStack& operator=(const LayerStack&) = delete;
+    
+    Window& window;
+    std::vector<std::unique_ptr<RenderLayer>> layers;
+    std::vector<EventListenerId> eventListeners;
+};
+
+} // namespace ENGAIN
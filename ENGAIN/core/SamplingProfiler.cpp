@@ -0,0 +1,309 @@
+#include "SamplingProfiler.h"
+#include "Logger.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <thread>
+#include <unordered_map>
+
+#ifdef __linux__
+#define ENGAIN_HAS_SIGPROF 1
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <signal.h>
+#include <sys/time.h>
+#endif
+
+namespace ENGAIN {
+
+std::atomic<bool> SamplingProfiler::running(false);
+std::atomic<int> SamplingProfiler::activeHandlers(0);
+std::atomic<unsigned int> SamplingProfiler::currentFrame(0);
+std::atomic<size_t> SamplingProfiler::writeOffset(0);
+std::atomic<size_t> SamplingProfiler::committedOffset(0);
+std::atomic<uint64_t> SamplingProfiler::sampleCount(0);
+std::atomic<uint64_t> SamplingProfiler::droppedCount(0);
+std::unique_ptr<std::atomic<uintptr_t>[]> SamplingProfiler::buffer;
+size_t SamplingProfiler::bufferWords = 0;
+
+namespace {
+#ifdef ENGAIN_HAS_SIGPROF
+    // The handler and the kernel's signal trampoline
+    const int SKIPPED_FRAMES = 2;
+    
+    std::string symbolize(uintptr_t address) {
+        Dl_info info;
+        if (dladdr(reinterpret_cast<void*>(address), &info) && info.dli_sname) {
+            int status = 0;
+            char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+            std::string name = status == 0 && demangled ? demangled : info.dli_sname;
+            std::free(demangled);
+            return name;
+        }
+        
+        // No symbol (static function, or the binary was linked without
+        // -rdynamic): fall back to module+offset so it can be resolved later
+        char text[64];
+        if (dladdr(reinterpret_cast<void*>(address), &info) && info.dli_fname) {
+            const char* module = std::strrchr(info.dli_fname, '/');
+            std::snprintf(text, sizeof(text), "%s+0x%llx", module ? module + 1 : info.dli_fname,
+                          static_cast<unsigned long long>(address - reinterpret_cast<uintptr_t>(info.dli_fbase)));
+        } else {
+            std::snprintf(text, sizeof(text), "0x%llx", static_cast<unsigned long long>(address));
+        }
+        return text;
+    }
+#endif
+}
+
+SamplingProfiler& SamplingProfiler::getInstance() {
+    static SamplingProfiler instance;
+    return instance;
+}
+
+SamplingProfiler::SamplingProfiler()
+    : handlerInstalled(false),
+      firstFrame(0) {
+    // Construct the logger first so it outlives the profiler
+    Logger::getInstance();
+}
+
+SamplingProfiler::~SamplingProfiler() {
+    shutdown();
+}
+
+void SamplingProfiler::initialize() {
+    const char* path = std::getenv("ENGAIN_SAMPLE_PROFILE");
+    if (!path) return;
+    
+    SamplingConfig settings(997, *path ? path : "profile.folded");
+    if (const char* hz = std::getenv("ENGAIN_SAMPLE_HZ")) {
+        int value = std::atoi(hz);
+        if (value > 0) settings.frequency = value;
+    }
+    if (const char* slow = std::getenv("ENGAIN_SAMPLE_SLOW_MS")) {
+        float value = std::strtof(slow, nullptr);
+        if (value > 0.0f) {
+            settings.slowFrameThreshold = value / 1000.0f;
+            settings.groupByFrame = true;
+        }
+    }
+    start(settings);
+}
+
+bool SamplingProfiler::start(const SamplingConfig& newConfig) {
+#ifdef ENGAIN_HAS_SIGPROF
+    if (running.load(std::memory_order_acquire)) return true;
+    if (newConfig.frequency <= 0) return false;
+    
+    config = newConfig;
+    frameTimes.clear();
+    firstFrame = currentFrame.load(std::memory_order_relaxed);
+    
+    size_t words = config.bufferBytes / sizeof(uintptr_t);
+    if (!buffer || bufferWords != words) {
+        buffer.reset(new std::atomic<uintptr_t>[words]());
+        bufferWords = words;
+    } else {
+        // A zero depth ends the reader, so nothing from the last run is parsed
+        for (size_t i = 0; i < bufferWords; i++) {
+            buffer[i].store(0, std::memory_order_relaxed);
+        }
+    }
+    writeOffset.store(0, std::memory_order_relaxed);
+    committedOffset.store(0, std::memory_order_relaxed);
+    sampleCount.store(0, std::memory_order_relaxed);
+    droppedCount.store(0, std::memory_order_relaxed);
+    
+    // The first backtrace() call loads libgcc, which must not happen inside
+    // the signal handler
+    void* warmup[4];
+    backtrace(warmup, 4);
+    
+    if (!handlerInstalled) {
+        // Stays installed after stop(): the default action for a stray
+        // SIGPROF is to kill the process
+        struct sigaction action;
+        std::memset(&action, 0, sizeof(action));
+        action.sa_handler = &SamplingProfiler::handleSignal;
+        action.sa_flags = SA_RESTART;
+        sigemptyset(&action.sa_mask);
+        if (sigaction(SIGPROF, &action, nullptr) != 0) {
+            ENGAIN_LOG_ERROR(GENERAL, "Sampling profiler could not install a SIGPROF handler");
+            return false;
+        }
+        handlerInstalled = true;
+    }
+    
+    running.store(true, std::memory_order_seq_cst);
+    
+    long interval = 1000000L / config.frequency;
+    struct itimerval timer;
+    timer.it_interval.tv_sec = interval / 1000000L;
+    timer.it_interval.tv_usec = interval % 1000000L;
+    timer.it_value = timer.it_interval;
+    if (setitimer(ITIMER_PROF, &timer, nullptr) != 0) {
+        running.store(false, std::memory_order_seq_cst);
+        ENGAIN_LOG_ERROR(GENERAL, "Sampling profiler could not start the profiling timer");
+        return false;
+    }
+    
+    ENGAIN_LOG_INFO(GENERAL, "Sampling profiler started at " << config.frequency
+                    << " Hz, writing to " << config.outputPath);
+    return true;
+#else
+    (void)newConfig;
+    ENGAIN_LOG_WARNING(GENERAL, "Sampling profiler is only available on Linux");
+    return false;
+#endif
+}
+
+void SamplingProfiler::stop() {
+#ifdef ENGAIN_HAS_SIGPROF
+    if (!running.exchange(false, std::memory_order_seq_cst)) return;
+    
+    struct itimerval timer;
+    std::memset(&timer, 0, sizeof(timer));
+    setitimer(ITIMER_PROF, &timer, nullptr);
+    
+    // Let handlers that were already running finish their sample
+    while (activeHandlers.load(std::memory_order_seq_cst) > 0) {
+        std::this_thread::yield();
+    }
+    
+    if (!config.outputPath.empty()) {
+        writeFoldedStacks(config.outputPath);
+    }
+#endif
+}
+
+void SamplingProfiler::shutdown() {
+    stop();
+}
+
+void SamplingProfiler::onFrame(unsigned int frameNumber, float previousFrameTime) {
+    if (frameNumber > firstFrame) {
+        size_t index = frameNumber - 1 - firstFrame;
+        if (frameTimes.size() <= index) {
+            frameTimes.resize(index + 1, 0.0f);
+        }
+        frameTimes[index] = previousFrameTime;
+    }
+    currentFrame.store(frameNumber, std::memory_order_relaxed);
+}
+
+void SamplingProfiler::handleSignal(int) {
+#ifdef ENGAIN_HAS_SIGPROF
+    // Signal context: no allocation and no locks, and errno is preserved
+    int savedErrno = errno;
+    activeHandlers.fetch_add(1, std::memory_order_seq_cst);
+    
+    if (running.load(std::memory_order_seq_cst)) {
+        void* stack[MAX_DEPTH + SKIPPED_FRAMES];
+        int depth = backtrace(stack, MAX_DEPTH + SKIPPED_FRAMES) - SKIPPED_FRAMES;
+        size_t words = 2 + static_cast<size_t>(depth > 0 ? depth : 0);
+        size_t offset = depth > 0 ? writeOffset.fetch_add(words, std::memory_order_relaxed) : 0;
+        
+        if (depth <= 0 || offset + words > bufferWords) {
+            droppedCount.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            std::atomic<uintptr_t>* sample = buffer.get() + offset;
+            sample[0].store(static_cast<uintptr_t>(depth), std::memory_order_relaxed);
+            sample[1].store(currentFrame.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            for (int i = 0; i < depth; i++) {
+                sample[2 + i].store(reinterpret_cast<uintptr_t>(stack[SKIPPED_FRAMES + i]),
+                                    std::memory_order_relaxed);
+            }
+            sampleCount.fetch_add(1, std::memory_order_relaxed);
+            
+            size_t committed = committedOffset.load(std::memory_order_relaxed);
+            while (committed < offset + words &&
+                   !committedOffset.compare_exchange_weak(committed, offset + words, std::memory_order_relaxed)) {
+            }
+        }
+    }
+    
+    activeHandlers.fetch_sub(1, std::memory_order_seq_cst);
+    errno = savedErrno;
+#endif
+}
+
+bool SamplingProfiler::writeFoldedStacks(const std::string& path) {
+#ifdef ENGAIN_HAS_SIGPROF
+    if (running.load(std::memory_order_acquire)) {
+        ENGAIN_LOG_WARNING(GENERAL, "Stop the sampling profiler before writing its samples");
+        return false;
+    }
+    
+    FILE* file = std::fopen(path.c_str(), "w");
+    if (!file) {
+        ENGAIN_LOG_ERROR(GENERAL, "Failed to open sampling profile: " << path);
+        return false;
+    }
+    
+    std::unordered_map<uintptr_t, std::string> symbols;
+    std::map<std::string, uint64_t> stacks;
+    uint64_t kept = 0;
+    size_t end = std::min(committedOffset.load(std::memory_order_acquire), bufferWords);
+    std::string line;
+    
+    for (size_t offset = 0; offset + 2 <= end;) {
+        const std::atomic<uintptr_t>* sample = buffer.get() + offset;
+        size_t depth = sample[0].load(std::memory_order_relaxed);
+        unsigned int frame = static_cast<unsigned int>(sample[1].load(std::memory_order_relaxed));
+        offset += 2 + depth;
+        if (depth == 0 || offset > end) break;
+        
+        if (config.slowFrameThreshold > 0.0f) {
+            // Samples from frames that are unfinished or fast are skipped
+            if (frame < firstFrame || frame - firstFrame >= frameTimes.size() ||
+                frameTimes[frame - firstFrame] <= config.slowFrameThreshold) {
+                continue;
+            }
+        }
+        
+        line.clear();
+        if (config.groupByFrame) {
+            line = "frame " + std::to_string(frame);
+        }
+        
+        // Root first; return addresses point after the call, so step back
+        // into the calling instruction before looking them up
+        for (size_t i = depth; i-- > 0;) {
+            uintptr_t address = sample[2 + i].load(std::memory_order_relaxed);
+            if (i > 0) address -= 1;
+            
+            auto found = symbols.find(address);
+            if (found == symbols.end()) {
+                found = symbols.emplace(address, symbolize(address)).first;
+            }
+            if (!line.empty()) line += ';';
+            line += found->second;
+        }
+        stacks[line]++;
+        kept++;
+    }
+    
+    for (const auto& stack : stacks) {
+        std::fprintf(file, "%s %llu\n", stack.first.c_str(), static_cast<unsigned long long>(stack.second));
+    }
+    std::fclose(file);
+    
+    uint64_t dropped = droppedCount.load(std::memory_order_relaxed);
+    if (dropped > 0) {
+        ENGAIN_LOG_WARNING(GENERAL, "Sampling buffer was full, " << dropped << " samples dropped");
+    }
+    ENGAIN_LOG_INFO(GENERAL, "Wrote " << kept << " of " << getSampleCount()
+                    << " samples as " << stacks.size() << " folded stacks to " << path);
+    return true;
+#else
+    (void)path;
+    return false;
+#endif
+}
+
+} // namespace ENGAIN
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ENGAIN {
+
+struct SamplingConfig {
+    int frequency;              // Samples per second of CPU time
+    float slowFrameThreshold;   // Seconds; when > 0 only frames slower than this are written
+    bool groupByFrame;          // Root every stack at "frame N" instead of merging frames
+    size_t bufferBytes;         // Sample storage; sampling stops once it is full
+    std::string outputPath;
+    
+    SamplingConfig(int frequency = 997, const std::string& outputPath = "profile.folded")
+        : frequency(frequency), slowFrameThreshold(0.0f), groupByFrame(false),
+          bufferBytes(16 * 1024 * 1024), outputPath(outputPath) {}
+};
+
+// Statistical CPU profiler. SIGPROF fires at a fixed rate of process CPU
+// time, the handler unwinds the interrupted thread's stack into a
+// preallocated buffer, and stop() symbolizes the samples and writes them as
+// folded stacks for flamegraph.pl, speedscope or inferno. Each sample is
+// tagged with the frame number TimeManager reported last, so slow frames
+// can be looked at on their own. Linux only; elsewhere start() fails.
+class SamplingProfiler {
+public:
+    static SamplingProfiler& getInstance();
+    
+    // Starts sampling if ENGAIN_SAMPLE_PROFILE is set, using its value as
+    // the output path. ENGAIN_SAMPLE_HZ sets the frequency and
+    // ENGAIN_SAMPLE_SLOW_MS keeps only frames slower than that.
+    void initialize();
+    
+    bool start(const SamplingConfig& config = SamplingConfig());
+    // Stop sampling and write the folded stacks to the configured path
+    void stop();
+    void shutdown();
+    
+    static bool isRunning() { return running.load(std::memory_order_relaxed); }
+    
+    // Called by TimeManager::update(): frameNumber starts, and the frame
+    // before it took previousFrameTime seconds
+    void onFrame(unsigned int frameNumber, float previousFrameTime);
+    
+    bool writeFoldedStacks(const std::string& path);
+    
+    uint64_t getSampleCount() const { return sampleCount.load(std::memory_order_relaxed); }
+    uint64_t getDroppedCount() const { return droppedCount.load(std::memory_order_relaxed); }
+
+private:
+    SamplingProfiler();
+    ~SamplingProfiler();
+    SamplingProfiler(const SamplingProfiler&) = delete;
+    SamplingProfiler& operator=(const SamplingProfiler&) = delete;
+    
+    static void handleSignal(int signal);
+    
+    // Each sample is [depth][frame][pc 0 .. pc depth-1], leaf first
+    static const int MAX_DEPTH = 64;
+    
+    static std::atomic<bool> running;
+    static std::atomic<int> activeHandlers;
+    static std::atomic<unsigned int> currentFrame;
+    static std::atomic<size_t> writeOffset;
+    // End of the last sample that fit; writeOffset runs past the buffer once
+    // samples start being dropped
+    static std::atomic<size_t> committedOffset;
+    static std::atomic<uint64_t> sampleCount;
+    static std::atomic<uint64_t> droppedCount;
+    static std::unique_ptr<std::atomic<uintptr_t>[]> buffer;
+    static size_t bufferWords;
+    
+    SamplingConfig config;
+    bool handlerInstalled;
+    
+    // Duration of each frame since start(), indexed from firstFrame
+    std::vector<float> frameTimes;
+    unsigned int firstFrame;
+};
+
+} // namespace ENGAIN
@@ -0,0 +1,242 @@
+#include "SpriteBatch.h"
+#include "Logger.h"
+#include "LogThrottle.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <cmath>
+
+namespace ENGAIN {
+
+namespace {
+    const float DEGREES_TO_RADIANS = 3.14159265358979f / 180.0f;
+}
+
+SpriteBatch::SpriteBatch(size_t reserveSprites)
+    : renderer(nullptr),
+      texture(nullptr),
+      textureWidth(1.0f),
+      textureHeight(1.0f),
+      drawCalls(0),
+      spritesDrawn(0) {
+    reserve(reserveSprites);
+}
+
+void SpriteBatch::begin(SDL_Renderer* newRenderer) {
+    flush();
+    renderer = newRenderer;
+    // A texture rebuilt since last frame can reuse the old address with
+    // another size, so query it again
+    texture = nullptr;
+    drawCalls = 0;
+    spritesDrawn = 0;
+}
+
+void SpriteBatch::end() {
+    flush();
+}
+
+void SpriteBatch::draw(const AtlasRegion& region, const SDL_FRect& dest, float angle,
+                       const SDL_FPoint* center, SDL_Color tint, SDL_RendererFlip flip) {
+    if (!region.texture) return;
+    
+    if (region.texture != texture) {
+        flush();
+        texture = region.texture;
+        int w = 1;
+        int h = 1;
+        SDL_QueryTexture(texture, nullptr, nullptr, &w, &h);
+        textureWidth = static_cast<float>(std::max(w, 1));
+        textureHeight = static_cast<float>(std::max(h, 1));
+    }
+    
+    float centerX = center ? center->x : dest.w * 0.5f;
+    float centerY = center ? center->y : dest.h * 0.5f;
+    pivotX.push_back(dest.x + centerX);
+    pivotY.push_back(dest.y + centerY);
+    left.push_back(-centerX);
+    top.push_back(-centerY);
+    right.push_back(dest.w - centerX);
+    bottom.push_back(dest.h - centerY);
+    
+    float radians = angle * DEGREES_TO_RADIANS;
+    cosAngle.push_back(std::cos(radians));
+    sinAngle.push_back(std::sin(radians));
+    
+    float sourceLeft = region.source.x / textureWidth;
+    float sourceTop = region.source.y / textureHeight;
+    float sourceRight = (region.source.x + region.source.w) / textureWidth;
+    float sourceBottom = (region.source.y + region.source.h) / textureHeight;
+    if (flip & SDL_FLIP_HORIZONTAL) std::swap(sourceLeft, sourceRight);
+    if (flip & SDL_FLIP_VERTICAL) std::swap(sourceTop, sourceBottom);
+    u0.push_back(sourceLeft);
+    v0.push_back(sourceTop);
+    u1.push_back(sourceRight);
+    v1.push_back(sourceBottom);
+    
+    tints.push_back(tint);
+}
+
+void SpriteBatch::draw(const AtlasRegion& region, float x, float y, float angle, float scale, SDL_Color tint) {
+    float w = region.source.w * scale;
+    float h = region.source.h * scale;
+    draw(region, SDL_FRect{x - w * 0.5f, y - h * 0.5f, w, h}, angle, nullptr, tint);
+}
+
+void SpriteBatch::flush() {
+    size_t count = pivotX.size();
+    if (count == 0) return;
+    
+    if (renderer && texture) {
+        ENGAIN_PROFILE_SCOPE("SpriteBatch::flush");
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+        buildVertices(count);
+        buildIndices(count);
+        int vertexCount = static_cast<int>(count * 4);
+        if (SDL_RenderGeometryRaw(renderer, texture,
+                                  positions.data(), 2 * sizeof(float),
+                                  colors.data(), sizeof(SDL_Color),
+                                  texCoords.data(), 2 * sizeof(float),
+                                  vertexCount, indices.data(), static_cast<int>(count * 6), sizeof(int)) != 0) {
+            ENGAIN_LOG_THROTTLED(LogLevel::WARNING, RENDER, 1, 5.0f,
+                                 "SDL_RenderGeometryRaw failed: " << SDL_GetError());
+        } else {
+            drawCalls++;
+        }
+#else
+        drawFallback(count);
+#endif
+        spritesDrawn += static_cast<unsigned int>(count);
+    }
+    
+    pivotX.clear();
+    pivotY.clear();
+    left.clear();
+    top.clear();
+    right.clear();
+    bottom.clear();
+    cosAngle.clear();
+    sinAngle.clear();
+    u0.clear();
+    v0.clear();
+    u1.clear();
+    v1.clear();
+    tints.clear();
+}
+
+void SpriteBatch::reserve(size_t sprites) {
+    pivotX.reserve(sprites);
+    pivotY.reserve(sprites);
+    left.reserve(sprites);
+    top.reserve(sprites);
+    right.reserve(sprites);
+    bottom.reserve(sprites);
+    cosAngle.reserve(sprites);
+    sinAngle.reserve(sprites);
+    u0.reserve(sprites);
+    v0.reserve(sprites);
+    u1.reserve(sprites);
+    v1.reserve(sprites);
+    tints.reserve(sprites);
+}
+
+void SpriteBatch::buildVertices(size_t count) {
+    positions.resize(count * 8);
+    texCoords.resize(count * 8);
+    colors.resize(count * 4);
+    
+    // Corners in order top-left, top-right, bottom-left, bottom-right,
+    // rotated about the pivot: x' = x cos - y sin, y' = x sin + y cos.
+    // Straight-line math over plain arrays, so the compiler vectorizes it.
+    const float* px = pivotX.data();
+    const float* py = pivotY.data();
+    const float* l = left.data();
+    const float* t = top.data();
+    const float* r = right.data();
+    const float* b = bottom.data();
+    const float* c = cosAngle.data();
+    const float* s = sinAngle.data();
+    float* out = positions.data();
+    for (size_t i = 0; i < count; i++) {
+        float lc = l[i] * c[i];
+        float ls = l[i] * s[i];
+        float rc = r[i] * c[i];
+        float rs = r[i] * s[i];
+        float tc = t[i] * c[i];
+        float ts = t[i] * s[i];
+        float bc = b[i] * c[i];
+        float bs = b[i] * s[i];
+        float* corner = out + i * 8;
+        corner[0] = px[i] + lc - ts;
+        corner[1] = py[i] + ls + tc;
+        corner[2] = px[i] + rc - ts;
+        corner[3] = py[i] + rs + tc;
+        corner[4] = px[i] + lc - bs;
+        corner[5] = py[i] + ls + bc;
+        corner[6] = px[i] + rc - bs;
+        corner[7] = py[i] + rs + bc;
+    }
+    
+    float* uv = texCoords.data();
+    for (size_t i = 0; i < count; i++) {
+        float* corner = uv + i * 8;
+        corner[0] = u0[i];
+        corner[1] = v0[i];
+        corner[2] = u1[i];
+        corner[3] = v0[i];
+        corner[4] = u0[i];
+        corner[5] = v1[i];
+        corner[6] = u1[i];
+        corner[7] = v1[i];
+    }
+    
+    for (size_t i = 0; i < count; i++) {
+        colors[i * 4] = tints[i];
+        colors[i * 4 + 1] = tints[i];
+        colors[i * 4 + 2] = tints[i];
+        colors[i * 4 + 3] = tints[i];
+    }
+}
+
+void SpriteBatch::buildIndices(size_t count) {
+    // The pattern never changes, so only new quads are filled in
+    size_t built = indices.size() / 6;
+    if (built >= count) return;
+    
+    indices.resize(count * 6);
+    for (size_t i = built; i < count; i++) {
+        int base = static_cast<int>(i * 4);
+        int* quad = &indices[i * 6];
+        quad[0] = base;
+        quad[1] = base + 1;
+        quad[2] = base + 2;
+        quad[3] = base + 2;
+        quad[4] = base + 1;
+        quad[5] = base + 3;
+    }
+}
+
+void SpriteBatch::drawFallback(size_t count) {
+    // SDL before 2.0.18 has no geometry API: one copy per sprite
+    for (size_t i = 0; i < count; i++) {
+        SDL_Rect source = {
+            static_cast<int>(std::min(u0[i], u1[i]) * textureWidth + 0.5f),
+            static_cast<int>(std::min(v0[i], v1[i]) * textureHeight + 0.5f),
+            static_cast<int>(std::fabs(u1[i] - u0[i]) * textureWidth + 0.5f),
+            static_cast<int>(std::fabs(v1[i] - v0[i]) * textureHeight + 0.5f)
+        };
+        SDL_FRect dest = {pivotX[i] + left[i], pivotY[i] + top[i], right[i] - left[i], bottom[i] - top[i]};
+        SDL_FPoint center = {-left[i], -top[i]};
+        int flip = (u0[i] > u1[i] ? SDL_FLIP_HORIZONTAL : 0) | (v0[i] > v1[i] ? SDL_FLIP_VERTICAL : 0);
+        double angle = std::atan2(sinAngle[i], cosAngle[i]) / DEGREES_TO_RADIANS;
+        
+        SDL_SetTextureColorMod(texture, tints[i].r, tints[i].g, tints[i].b);
+        SDL_SetTextureAlphaMod(texture, tints[i].a);
+        SDL_RenderCopyExF(renderer, texture, &source, &dest, angle, &center,
+                          static_cast<SDL_RendererFlip>(flip));
+        drawCalls++;
+    }
+    SDL_SetTextureColorMod(texture, 255, 255, 255);
+    SDL_SetTextureAlphaMod(texture, 255);
+}
+
+} // namespace ENGAIN
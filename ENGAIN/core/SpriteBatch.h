@@ -0,0 +1,84 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "TextureAtlas.h"
+
+namespace ENGAIN {
+
+// Collects rotated, scaled and tinted sprites and draws each run that uses
+// the same texture with one SDL_RenderGeometry call. Sprites are stored as
+// separate arrays per field and their corners are computed in one pass at
+// flush time, a loop the compiler can vectorize.
+//
+// Draw order is kept: a sprite from a different texture flushes what came
+// before it, so drawing from one atlas page gives one call per frame.
+// Anything drawn directly on the renderer in between has to call flush()
+// first to stay on top of the batched sprites.
+class SpriteBatch {
+public:
+    explicit SpriteBatch(size_t reserveSprites = 1024);
+    
+    // Starts counting draw calls for a new frame
+    void begin(SDL_Renderer* renderer);
+    // Flush what is left
+    void end();
+    void flush();
+    
+    // dest is the unrotated rectangle on screen; the sprite turns by angle
+    // degrees clockwise around center, relative to dest, or around its middle
+    void draw(const AtlasRegion& region, const SDL_FRect& dest, float angle = 0.0f,
+              const SDL_FPoint* center = nullptr, SDL_Color tint = SDL_Color{255, 255, 255, 255},
+              SDL_RendererFlip flip = SDL_FLIP_NONE);
+    // Centered on (x, y) at scale times the region size
+    void draw(const AtlasRegion& region, float x, float y, float angle = 0.0f, float scale = 1.0f,
+              SDL_Color tint = SDL_Color{255, 255, 255, 255});
+    
+    // Renderer given to begin(), for drawing around the batch
+    SDL_Renderer* getRenderer() const { return renderer; }
+    size_t getPendingCount() const { return pivotX.size(); }
+    // Since begin()
+    unsigned int getDrawCallCount() const { return drawCalls; }
+    unsigned int getSpriteCount() const { return spritesDrawn; }
+
+private:
+    void reserve(size_t sprites);
+    void buildVertices(size_t count);
+    void buildIndices(size_t count);
+    void drawFallback(size_t count);
+    
+    SDL_Renderer* renderer;
+    SDL_Texture* texture;
+    // Size of the current texture, for normalizing source rects
+    float textureWidth;
+    float textureHeight;
+    
+    // Per sprite: pivot on screen, corner offsets from the pivot before
+    // rotation, rotation, texture coordinates and tint
+    std::vector<float> pivotX;
+    std::vector<float> pivotY;
+    std::vector<float> left;
+    std::vector<float> top;
+    std::vector<float> right;
+    std::vector<float> bottom;
+    std::vector<float> cosAngle;
+    std::vector<float> sinAngle;
+    std::vector<float> u0;
+    std::vector<float> v0;
+    std::vector<float> u1;
+    std::vector<float> v1;
+    std::vector<SDL_Color> tints;
+    
+    // Four vertices per sprite, two triangles of indices per sprite
+    std::vector<float> positions;
+    std::vector<float> texCoords;
+    std::vector<SDL_Color> colors;
+    std::vector<int> indices;
+    
+    unsigned int drawCalls;
+    unsigned int spritesDrawn;
+};
+
+} // namespace ENGAIN
@@ -1,5 +1,7 @@
 #include "Texture.h"
 #include "Logger.h"
+#include "BinaryLog.h"
+#include "Profiler.h"
 #include <SDL2/SDL_image.h>
 
 namespace ENGAIN {
@@ -11,21 +13,19 @@ Texture::~Texture() {
 }
 
 bool Texture::loadFromFile(const std::string& path, SDL_Renderer* renderer) {
+    ENGAIN_PROFILE_SCOPE("Texture::loadFromFile");
     free();
     
     SDL_Surface* loadedSurface = IMG_Load(path.c_str());
     if (!loadedSurface) {
-        Logger::getInstance().error("Unable to load image " + path + "! SDL_image Error: " + IMG_GetError());
+        ENGAIN_LOG_ERROR(ASSETS, "Unable to load image " << path << "! SDL_image Error: " << IMG_GetError());
         return false;
     }
     
-    texture = SDL_CreateTextureFromSurface(renderer, loadedSurface);
-    if (!texture) {
-        Logger::getInstance().error("Unable to create texture from " + path + "! SDL Error: " + SDL_GetError());
+    if (!loadFromSurface(loadedSurface, renderer)) {
+        ENGAIN_LOG_ERROR(ASSETS, "Unable to create texture from " << path << "! SDL Error: " << SDL_GetError());
     } else {
-        width = loadedSurface->w;
-        height = loadedSurface->h;
-        Logger::getInstance().info("Loaded texture: " + path);
+        ENGAIN_LOGF_INFO(ASSETS, "Loaded texture: {}", path);
     }
     
     SDL_FreeSurface(loadedSurface);
@@ -33,6 +33,18 @@ bool Texture::loadFromFile(const std::string& path, SDL_Renderer* renderer) {
     return texture != nullptr;
 }
 
+bool Texture::loadFromSurface(SDL_Surface* surface, SDL_Renderer* renderer) {
+    free();
+    if (!surface) return false;
+    
+    texture = SDL_CreateTextureFromSurface(renderer, surface);
+    if (!texture) return false;
+    
+    width = surface->w;
+    height = surface->h;
+    return true;
+}
+
 void Texture::free() {
     if (texture) {
         SDL_DestroyTexture(texture);
@@ -65,6 +77,20 @@ void Texture::renderScaled(SDL_Renderer* renderer, int x, int y, int w, int h,
     SDL_RenderCopyEx(renderer, texture, nullptr, &renderQuad, 0, nullptr, flip);
 }
 
+void Texture::render(SDL_Renderer* renderer, const AtlasRegion& region, int x, int y) {
+    SDL_Rect renderQuad = {x, y, region.source.w, region.source.h};
+    SDL_RenderCopy(renderer, region.texture, &region.source, &renderQuad);
+}
+
+void Texture::renderEx(SDL_Renderer* renderer, const AtlasRegion& region, const SDL_Rect& dest,
+                       double angle, SDL_Point* center, SDL_RendererFlip flip) {
+    SDL_RenderCopyEx(renderer, region.texture, &region.source, &dest, angle, center, flip);
+}
+
+AtlasRegion Texture::getRegion() const {
+    return AtlasRegion(texture, SDL_Rect{0, 0, width, height});
+}
+
 void Texture::setColor(uint8_t r, uint8_t g, uint8_t b) {
     SDL_SetTextureColorMod(texture, r, g, b);
 }
@@ -3,6 +3,7 @@
 #include <SDL2/SDL.h>
 #include <string>
 #include <memory>
+#include "TextureAtlas.h"
 
 namespace ENGAIN {
 
@@ -12,6 +13,8 @@ public:
     ~Texture();
     
     bool loadFromFile(const std::string& path, SDL_Renderer* renderer);
+    // Upload an already decoded image; the surface stays with the caller
+    bool loadFromSurface(SDL_Surface* surface, SDL_Renderer* renderer);
     void free();
     
     void render(SDL_Renderer* renderer, int x, int y, SDL_Rect* clip = nullptr);
@@ -20,6 +23,16 @@ public:
     void renderScaled(SDL_Renderer* renderer, int x, int y, int w, int h, 
                      SDL_RendererFlip flip = SDL_FLIP_NONE);
     
+    // Draw an atlas region, or any other part of a texture, at its own size
+    // or stretched to dest
+    static void render(SDL_Renderer* renderer, const AtlasRegion& region, int x, int y);
+    static void renderEx(SDL_Renderer* renderer, const AtlasRegion& region, const SDL_Rect& dest,
+                         double angle = 0.0, SDL_Point* center = nullptr,
+                         SDL_RendererFlip flip = SDL_FLIP_NONE);
+    // The whole texture as a region, so loose textures and atlas sprites
+    // draw the same way
+    AtlasRegion getRegion() const;
+    
     int getWidth() const { return width; }
     int getHeight() const { return height; }
     
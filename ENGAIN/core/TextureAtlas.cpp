@@ -0,0 +1,291 @@
+#include "TextureAtlas.h"
+#include "Logger.h"
+#include "Profiler.h"
+#include <SDL2/SDL_image.h>
+#include <algorithm>
+
+namespace ENGAIN {
+
+namespace {
+    // Bottom-left skyline packer: the top edge of everything placed so far
+    // is kept as a list of horizontal segments, and each rectangle goes
+    // where its top ends up lowest
+    class Skyline {
+    public:
+        Skyline(int width, int height) : width(width), height(height) {
+            segments.push_back(Segment{0, 0, width});
+        }
+        
+        bool insert(int w, int h, SDL_Point& position) {
+            int bestTop = height + 1;
+            int bestWidth = width + 1;
+            size_t bestIndex = segments.size();
+            for (size_t i = 0; i < segments.size(); i++) {
+                int y = fit(i, w, h);
+                if (y < 0) continue;
+                // Lowest top first, then the narrowest segment to keep gaps small
+                if (y + h < bestTop || (y + h == bestTop && segments[i].width < bestWidth)) {
+                    bestTop = y + h;
+                    bestWidth = segments[i].width;
+                    bestIndex = i;
+                    position = SDL_Point{segments[i].x, y};
+                }
+            }
+            if (bestIndex == segments.size()) return false;
+            
+            place(bestIndex, position.x, position.y + h, w);
+            return true;
+        }
+
+    private:
+        struct Segment {
+            int x;
+            int y;
+            int width;
+        };
+        
+        // Top of a w x h rectangle whose left edge is at segment index, or -1
+        int fit(size_t index, int w, int h) const {
+            int x = segments[index].x;
+            if (x + w > width) return -1;
+            
+            int y = 0;
+            int widthLeft = w;
+            for (size_t i = index; widthLeft > 0; i++) {
+                y = std::max(y, segments[i].y);
+                if (y + h > height) return -1;
+                widthLeft -= segments[i].width;
+            }
+            return y;
+        }
+        
+        void place(size_t index, int x, int top, int w) {
+            segments.insert(segments.begin() + index, Segment{x, top, w});
+            
+            // Cut the segments the new one now covers
+            for (size_t i = index + 1; i < segments.size(); ) {
+                int covered = x + w - segments[i].x;
+                if (covered <= 0) break;
+                if (covered < segments[i].width) {
+                    segments[i].x += covered;
+                    segments[i].width -= covered;
+                    break;
+                }
+                segments.erase(segments.begin() + i);
+            }
+            
+            // Join neighbours at the same height
+            for (size_t i = 0; i + 1 < segments.size(); ) {
+                if (segments[i].y == segments[i + 1].y) {
+                    segments[i].width += segments[i + 1].width;
+                    segments.erase(segments.begin() + i + 1);
+                } else {
+                    i++;
+                }
+            }
+        }
+        
+        int width;
+        int height;
+        std::vector<Segment> segments;
+    };
+    
+    struct Page {
+        SDL_Surface* surface;
+        Skyline skyline;
+    };
+}
+
+TextureAtlas::TextureAtlas(int pageWidth, int pageHeight, int padding)
+    : pageWidth(pageWidth),
+      pageHeight(pageHeight),
+      padding(padding),
+      usedArea(0),
+      pageArea(0) {
+}
+
+TextureAtlas::~TextureAtlas() {
+    free();
+}
+
+bool TextureAtlas::addImage(const std::string& name, const std::string& path) {
+    SDL_Surface* loadedSurface = IMG_Load(path.c_str());
+    if (!loadedSurface) {
+        ENGAIN_LOG_ERROR(ASSETS, "Unable to load image " << path << " for the atlas! SDL_image Error: " << IMG_GetError());
+        return false;
+    }
+    
+    bool added = addSurface(name, loadedSurface);
+    SDL_FreeSurface(loadedSurface);
+    return added;
+}
+
+bool TextureAtlas::addSurface(const std::string& name, SDL_Surface* surface) {
+    if (!surface) return false;
+    
+    bool queued = std::any_of(pending.begin(), pending.end(),
+                              [&name](const PendingImage& image) { return image.name == name; });
+    if (queued || regions.count(name) > 0) {
+        ENGAIN_LOG_WARNING(ASSETS, "Atlas already has an image named '" << name << "'");
+        return false;
+    }
+    
+    SDL_Surface* copy = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_ARGB8888, 0);
+    if (!copy) {
+        ENGAIN_LOG_ERROR(ASSETS, "Unable to copy '" << name << "' for the atlas! SDL Error: " << SDL_GetError());
+        return false;
+    }
+    pending.push_back(PendingImage{name, copy});
+    return true;
+}
+
+bool TextureAtlas::build(SDL_Renderer* renderer) {
+    ENGAIN_PROFILE_SCOPE("TextureAtlas::build");
+    if (!renderer) return false;
+    
+    // A rebuild replaces the pages and every region with them
+    for (SDL_Texture* page : pages) {
+        SDL_DestroyTexture(page);
+    }
+    pages.clear();
+    regions.clear();
+    usedArea = 0;
+    pageArea = 0;
+    
+    int maxWidth = pageWidth;
+    int maxHeight = pageHeight;
+    SDL_RendererInfo info;
+    if (SDL_GetRendererInfo(renderer, &info) == 0 && info.max_texture_width > 0 && info.max_texture_height > 0) {
+        maxWidth = std::min(maxWidth, info.max_texture_width);
+        maxHeight = std::min(maxHeight, info.max_texture_height);
+    }
+    
+    // Tallest first packs a skyline tightest
+    std::vector<size_t> order(pending.size());
+    for (size_t i = 0; i < order.size(); i++) {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+        const SDL_Surface* first = pending[a].surface;
+        const SDL_Surface* second = pending[b].surface;
+        return first->h != second->h ? first->h > second->h : first->w > second->w;
+    });
+    
+    std::vector<Page> packed;
+    bool ok = true;
+    for (size_t index : order) {
+        const PendingImage& image = pending[index];
+        int w = image.surface->w + padding * 2;
+        int h = image.surface->h + padding * 2;
+        
+        SDL_Point position = {0, 0};
+        size_t pageIndex = packed.size();
+        for (size_t i = 0; i < packed.size(); i++) {
+            if (packed[i].skyline.insert(w, h, position)) {
+                pageIndex = i;
+                break;
+            }
+        }
+        
+        if (pageIndex == packed.size()) {
+            if (image.surface->w > maxWidth || image.surface->h > maxHeight) {
+                ENGAIN_LOG_ERROR(ASSETS, "Atlas image '" << image.name << "' is larger than the maximum texture size "
+                                 << maxWidth << "x" << maxHeight);
+                ok = false;
+                continue;
+            }
+            
+            // An image that only fits without its padding gets a page of its own
+            bool fitsPage = w <= maxWidth && h <= maxHeight;
+            int newWidth = fitsPage ? maxWidth : std::min(w, maxWidth);
+            int newHeight = fitsPage ? maxHeight : std::min(h, maxHeight);
+            w = std::min(w, newWidth);
+            h = std::min(h, newHeight);
+            
+            SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, newWidth, newHeight, 32, SDL_PIXELFORMAT_ARGB8888);
+            if (!surface) {
+                ENGAIN_LOG_ERROR(ASSETS, "Unable to create atlas page! SDL Error: " << SDL_GetError());
+                ok = false;
+                break;
+            }
+            packed.push_back(Page{surface, Skyline(newWidth, newHeight)});
+            packed.back().skyline.insert(w, h, position);
+        }
+        
+        // Copy the pixels as they are, alpha included
+        SDL_Surface* page = packed[pageIndex].surface;
+        SDL_Rect source = {position.x + padding, position.y + padding, image.surface->w, image.surface->h};
+        if (w < image.surface->w + padding * 2 || h < image.surface->h + padding * 2) {
+            // Padding was trimmed on a page of its own
+            source.x = position.x;
+            source.y = position.y;
+        }
+        SDL_Rect destination = source;
+        SDL_SetSurfaceBlendMode(image.surface, SDL_BLENDMODE_NONE);
+        SDL_BlitSurface(image.surface, nullptr, page, &destination);
+        
+        regions[image.name] = AtlasRegion(nullptr, source, static_cast<int>(pageIndex));
+        usedArea += static_cast<long long>(source.w) * source.h;
+    }
+    
+    for (const Page& page : packed) {
+        SDL_Texture* texture = ok ? SDL_CreateTextureFromSurface(renderer, page.surface) : nullptr;
+        if (ok && !texture) {
+            ENGAIN_LOG_ERROR(ASSETS, "Unable to upload atlas page! SDL Error: " << SDL_GetError());
+            ok = false;
+        }
+        if (texture) {
+            SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+            pages.push_back(texture);
+            pageArea += static_cast<long long>(page.surface->w) * page.surface->h;
+        }
+        SDL_FreeSurface(page.surface);
+    }
+    freePending();
+    
+    if (!ok) {
+        free();
+        return false;
+    }
+    
+    for (auto& entry : regions) {
+        entry.second.texture = pages[entry.second.page];
+    }
+    
+    ENGAIN_LOG_INFO(ASSETS, "Texture atlas built: " << regions.size() << " images in " << pages.size()
+                    << " page(s), " << getOccupancy() * 100.0f << "% occupied");
+    return true;
+}
+
+void TextureAtlas::free() {
+    for (SDL_Texture* page : pages) {
+        SDL_DestroyTexture(page);
+    }
+    pages.clear();
+    regions.clear();
+    usedArea = 0;
+    pageArea = 0;
+    freePending();
+}
+
+AtlasRegion TextureAtlas::getRegion(const std::string& name) const {
+    auto it = regions.find(name);
+    if (it == regions.end()) {
+        ENGAIN_LOG_WARNING(ASSETS, "Atlas has no image named '" << name << "'");
+        return AtlasRegion();
+    }
+    return it->second;
+}
+
+float TextureAtlas::getOccupancy() const {
+    return pageArea > 0 ? static_cast<float>(usedArea) / pageArea : 0.0f;
+}
+
+void TextureAtlas::freePending() {
+    for (PendingImage& image : pending) {
+        SDL_FreeSurface(image.surface);
+    }
+    pending.clear();
+}
+
+} // namespace ENGAIN
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ENGAIN {
+
+// Part of a texture that holds one sprite. Regions are plain handles: the
+// texture belongs to the TextureAtlas or Texture that handed them out.
+struct AtlasRegion {
+    SDL_Texture* texture;
+    SDL_Rect source;
+    int page;
+    
+    AtlasRegion() : texture(nullptr), source{0, 0, 0, 0}, page(-1) {}
+    AtlasRegion(SDL_Texture* texture, const SDL_Rect& source, int page = 0)
+        : texture(texture), source(source), page(page) {}
+    
+    bool isValid() const { return texture != nullptr; }
+    int getWidth() const { return source.w; }
+    int getHeight() const { return source.h; }
+};
+
+// Packs many images into a few large texture pages at load time, so sprites
+// drawn one after another share a texture and SDL can batch them. Images are
+// placed with a skyline packer, tallest first; one that does not fit in a
+// page gets a page of its own size.
+class TextureAtlas {
+public:
+    // Pages are clamped to the renderer's maximum texture size. Padding is
+    // left transparent around every image so filtering does not bleed.
+    explicit TextureAtlas(int pageWidth = 2048, int pageHeight = 2048, int padding = 2);
+    ~TextureAtlas();
+    
+    // Queue an image for the next build(); names must be unique
+    bool addImage(const std::string& name, const std::string& path);
+    // The atlas keeps a copy of the surface
+    bool addSurface(const std::string& name, SDL_Surface* surface);
+    
+    // Pack everything queued and upload the pages. Regions from an earlier
+    // build stay valid only until this is called again.
+    bool build(SDL_Renderer* renderer);
+    void free();
+    
+    // Invalid region if the name is unknown or the atlas is not built
+    AtlasRegion getRegion(const std::string& name) const;
+    bool hasRegion(const std::string& name) const { return regions.count(name) > 0; }
+    
+    size_t getPageCount() const { return pages.size(); }
+    SDL_Texture* getPage(size_t index) const { return pages[index]; }
+    // Fraction of the page area covered by images
+    float getOccupancy() const;
+
+private:
+    struct PendingImage {
+        std::string name;
+        SDL_Surface* surface;
+    };
+    
+    void freePending();
+    
+    int pageWidth;
+    int pageHeight;
+    int padding;
+    
+    std::vector<PendingImage> pending;
+    std::vector<SDL_Texture*> pages;
+    std::unordered_map<std::string, AtlasRegion> regions;
+    long long usedArea;
+    long long pageArea;
+};
+
+} // namespace ENGAIN
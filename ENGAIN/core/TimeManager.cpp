@@ -1,32 +1,57 @@
 #include "TimeManager.h"
 #include "Logger.h"
+#include "LogThrottle.h"
+#include "Profiler.h"
+#include "FlightRecorder.h"
+#include "SamplingProfiler.h"
 #include <thread>
-#include <numeric>
-#include <sstream>
 
 namespace ENGAIN {
 
+namespace {
+    // Time always left for the spin phase on top of the learned oversleep
+    const std::chrono::microseconds SPIN_MARGIN(200);
+    // Below this much remaining time the limiter busy-waits instead of yielding
+    const std::chrono::microseconds YIELD_LIMIT(50);
+    // Frames up to 10% over the target still count as on budget, so timer
+    // noise around an on-time frame is not reported as a slow frame
+    const float FRAME_BUDGET_SLACK = 1.1f;
+}
+
 TimeManager::TimeManager(int targetFPS)
-    : targetFPS(targetFPS),
-      targetFrameTime(targetFPS > 0 ? 1.0f / targetFPS : 0.0f),
+    : clock(new SystemClock()),
+      targetFPS(targetFPS),
+      frameDuration(targetFPS > 0 ? std::chrono::duration_cast<Clock::Duration>(
+                        std::chrono::duration<double>(1.0 / targetFPS)) : Clock::Duration::zero()),
+      oversleepEstimate(std::chrono::milliseconds(1)),
       deltaTime(0.0f),
       totalTime(0.0f),
       frameCount(0),
       fps(0.0f),
       fpsUpdateInterval(0.5f),
       fpsTimer(0.0f),
-      fpsFrameCount(0) {
+      fpsFrameCount(0),
+      fixedDeltaTime(0.0f),
+      maxStepsPerFrame(5),
+      accumulator(0.0f),
+      stepsThisFrame(0),
+      fixedStepCount(0),
+      droppedStepCount(0),
+      frameStats(600, (targetFPS > 0 ? 1.0f / targetFPS : 1.0f / 60.0f) * FRAME_BUDGET_SLACK),
+      perfCounters(nullptr),
+      perfIntervalFrames(0),
+      perfFrameFinished(true) {
     
-    lastTime = Clock::now();
-    currentTime = Clock::now();
+    lastTime = clock->now();
+    currentTime = lastTime;
+    frameDeadline = lastTime + frameDuration;
     
-    std::ostringstream oss;
-    oss << "TimeManager initialized with target FPS: " << targetFPS;
-    Logger::getInstance().info(oss.str());
+    ENGAIN_LOG_INFO(TIME, "TimeManager initialized with target FPS: " << targetFPS);
 }
 
 void TimeManager::update() {
-    currentTime = Clock::now();
+    clock->tick();
+    currentTime = clock->now();
     
     std::chrono::duration<float> elapsed = currentTime - lastTime;
     deltaTime = elapsed.count();
@@ -36,10 +61,32 @@ void TimeManager::update() {
     totalTime += deltaTime;
     frameCount++;
     
-    // Store frame time for averaging
-    frameTimes.push_back(deltaTime);
-    if (frameTimes.size() > MAX_FRAME_HISTORY) {
-        frameTimes.pop_front();
+    if (fixedDeltaTime > 0.0f) {
+        accumulator += deltaTime;
+        stepsThisFrame = 0;
+    } else {
+        timers.advance(deltaTime);
+    }
+    
+    if (perfCounters) {
+        // Without limitFPS() the whole interval counts as the frame
+        if (!perfFrameFinished) {
+            finishPerfFrame();
+        }
+        perfCounters->read(frameStartCounters);
+        perfFrameFinished = false;
+    }
+    
+    // Record frame time for statistics
+    frameStats.addSample(deltaTime);
+    
+    if (SamplingProfiler::isRunning()) {
+        SamplingProfiler::getInstance().onFrame(frameCount, deltaTime);
+    }
+    
+    FlightRecorder& recorder = FlightRecorder::getInstance();
+    if (recorder.isEnabled()) {
+        recorder.recordFrame(frameCount, targetFPS > 0 ? 1.0f / targetFPS : frameStats.getAverage());
     }
     
     // Update FPS
@@ -48,44 +95,161 @@ void TimeManager::update() {
     
     if (fpsTimer >= fpsUpdateInterval) {
         fps = fpsFrameCount / fpsTimer;
+        if (perfIntervalFrames > 0) {
+            averageFrameCounters = perfIntervalTotals / perfIntervalFrames;
+            perfIntervalTotals = PerfCounterValues();
+            perfIntervalFrames = 0;
+        }
         fpsTimer = 0.0f;
         fpsFrameCount = 0;
     }
 }
 
 void TimeManager::limitFPS() {
-    if (targetFPS <= 0) return;
+    ENGAIN_PROFILE_SCOPE("TimeManager::limitFPS");
+    if (perfCounters && !perfFrameFinished) {
+        finishPerfFrame();
+    }
+    if (targetFPS <= 0 || clock->isVirtual()) return;
     
-    auto now = Clock::now();
-    std::chrono::duration<float> elapsed = now - lastTime;
-    float sleepTime = targetFrameTime - elapsed.count();
+    TimePoint now = clock->now();
+    if (now < frameDeadline) {
+        // Coarse sleep, waking early enough to absorb the usual oversleep
+        TimePoint wakeTarget = frameDeadline - oversleepEstimate - SPIN_MARGIN;
+        if (wakeTarget > now) {
+            std::this_thread::sleep_until(wakeTarget);
+            now = clock->now();
+            
+            // Track the scheduler's oversleep with a moving average
+            Clock::Duration oversleep = now - wakeTarget;
+            oversleepEstimate += (oversleep - oversleepEstimate) / 8;
+            if (oversleepEstimate < Clock::Duration::zero()) {
+                oversleepEstimate = Clock::Duration::zero();
+            } else if (oversleepEstimate > frameDuration / 2) {
+                oversleepEstimate = frameDuration / 2;
+            }
+        }
+        
+        // Yield, then spin for the final slice
+        while (now < frameDeadline) {
+            if (frameDeadline - now > YIELD_LIMIT) {
+                std::this_thread::yield();
+            }
+            now = clock->now();
+        }
+    }
+    
+    frameDeadline += frameDuration;
     
-    if (sleepTime > 0) {
-        std::this_thread::sleep_for(
-            std::chrono::duration<float>(sleepTime)
-        );
+    // More than a frame behind (a hitch or a breakpoint): start a new
+    // schedule rather than rushing frames out to catch up
+    if (frameDeadline < now) {
+        frameDeadline = now + frameDuration;
     }
 }
 
-float TimeManager::getAverageFrameTime() const {
-    if (frameTimes.empty()) return 0.0f;
+bool TimeManager::enablePerfCounters() {
+    perfCounters = PerfCounters::forCurrentThread();
+    if (!perfCounters) return false;
     
-    float sum = std::accumulate(frameTimes.begin(), frameTimes.end(), 0.0f);
-    return sum / frameTimes.size();
+    perfCounters->read(frameStartCounters);
+    perfFrameFinished = false;
+    return true;
+}
+
+void TimeManager::finishPerfFrame() {
+    PerfCounterValues now;
+    if (perfCounters->read(now)) {
+        frameCounters = now - frameStartCounters;
+        perfIntervalTotals += frameCounters;
+        perfIntervalFrames++;
+    }
+    perfFrameFinished = true;
+}
+
+void TimeManager::setFixedTimestep(float tickRate, int maxSteps) {
+    fixedDeltaTime = tickRate > 0.0f ? 1.0f / tickRate : 0.0f;
+    maxStepsPerFrame = maxSteps > 0 ? maxSteps : 1;
+    accumulator = 0.0f;
+    stepsThisFrame = 0;
+    
+    if (fixedDeltaTime > 0.0f) {
+        ENGAIN_LOG_INFO(TIME, "Fixed timestep enabled: " << tickRate << " Hz, max "
+                        << maxStepsPerFrame << " steps per frame");
+    } else {
+        ENGAIN_LOG_INFO(TIME, "Fixed timestep disabled");
+    }
+}
+
+bool TimeManager::consumeFixedStep() {
+    if (fixedDeltaTime <= 0.0f || accumulator < fixedDeltaTime) {
+        return false;
+    }
+    
+    if (stepsThisFrame >= maxStepsPerFrame) {
+        // Too far behind to catch up: drop the backlog, keep the remainder
+        unsigned int dropped = static_cast<unsigned int>(accumulator / fixedDeltaTime);
+        droppedStepCount += dropped;
+        accumulator -= dropped * fixedDeltaTime;
+        ENGAIN_LOG_THROTTLED(LogLevel::WARNING, TIME, 1, 5.0f,
+                             "Simulation fell behind, dropped " << dropped << " fixed steps");
+        return false;
+    }
+    
+    accumulator -= fixedDeltaTime;
+    stepsThisFrame++;
+    fixedStepCount++;
+    timers.advance(fixedDeltaTime);
+    return true;
+}
+
+float TimeManager::getInterpolationAlpha() const {
+    if (fixedDeltaTime <= 0.0f) return 1.0f;
+    
+    float alpha = accumulator / fixedDeltaTime;
+    return alpha < 1.0f ? alpha : 1.0f;
+}
+
+void TimeManager::setClock(std::unique_ptr<Clock> newClock) {
+    if (!newClock) return;
+    
+    clock = std::move(newClock);
+    lastTime = clock->now();
+    currentTime = lastTime;
+    frameDeadline = lastTime + frameDuration;
+}
+
+void TimeManager::useVirtualClock(float frameTime) {
+    setClock(std::unique_ptr<Clock>(new VirtualClock(frameTime)));
+    ENGAIN_LOG_INFO(TIME, "Using virtual clock, " << frameTime * 1000.0f << " ms per frame");
+}
+
+void TimeManager::useSystemClock() {
+    setClock(std::unique_ptr<Clock>(new SystemClock()));
+    ENGAIN_LOG_INFO(TIME, "Using system clock");
+}
+
+float TimeManager::getOversleepEstimate() const {
+    return std::chrono::duration<float>(oversleepEstimate).count();
 }
 
 void TimeManager::reset() {
-    lastTime = Clock::now();
-    currentTime = Clock::now();
+    lastTime = clock->now();
+    currentTime = lastTime;
+    frameDeadline = lastTime + frameDuration;
     deltaTime = 0.0f;
     frameCount = 0;
     totalTime = 0.0f;
     fps = 0.0f;
     fpsTimer = 0.0f;
     fpsFrameCount = 0;
-    frameTimes.clear();
+    frameStats.reset();
+    accumulator = 0.0f;
+    stepsThisFrame = 0;
+    fixedStepCount = 0;
+    droppedStepCount = 0;
     
-    Logger::getInstance().info("TimeManager reset");
+    ENGAIN_LOG_INFO(TIME, "TimeManager reset");
 }
 
 } // namespace ENGAIN
@@ -1,7 +1,11 @@
 #pragma once
 
 #include <chrono>
-#include <deque>
+#include <memory>
+#include "Clock.h"
+#include "FrameStats.h"
+#include "PerfCounters.h"
+#include "TimerWheel.h"
 
 namespace ENGAIN {
 
@@ -10,23 +14,77 @@ public:
     TimeManager(int targetFPS = 60);
     
     void update();
+    // Waits until the next frame deadline: sleeps for most of the remaining
+    // time, then yields and spins for the last slice. Deadlines advance by
+    // a whole frame each call, so pacing error does not build up.
     void limitFPS();
     void reset();
     
+    // Fixed-step simulation: update() accumulates frame time and
+    // consumeFixedStep() hands it out in ticks of 1/tickRate seconds.
+    // At most maxStepsPerFrame ticks run per frame; time beyond that is
+    // dropped so a slow frame cannot snowball. A tickRate of 0 disables it.
+    void setFixedTimestep(float tickRate, int maxStepsPerFrame = 5);
+    bool consumeFixedStep();
+    
+    // Replace the time source. With a virtual clock every update() advances
+    // by exactly frameTime and limitFPS() returns immediately, so a game can
+    // run faster than real time with the same deltas on every run.
+    void setClock(std::unique_ptr<Clock> newClock);
+    void useVirtualClock(float frameTime);
+    void useSystemClock();
+    bool isVirtualClock() const { return clock->isVirtual(); }
+    
+    // Read hardware counters for the calling thread around every frame.
+    // The limiter's wait is left out when limitFPS() is used. Returns false
+    // if the counters cannot be opened.
+    bool enablePerfCounters();
+    bool hasPerfCounters() const { return perfCounters != nullptr; }
+    // Counters for the last finished frame
+    const PerfCounterValues& getFrameCounters() const { return frameCounters; }
+    // Per-frame average over the FPS update interval
+    const PerfCounterValues& getAverageFrameCounters() const { return averageFrameCounters; }
+    
+    // Game timers. They advance with each fixed step when fixed-step
+    // simulation is on, so they fire inside consumeFixedStep(); otherwise
+    // update() advances them by the frame time.
+    TimerWheel& getTimers() { return timers; }
+    const TimerWheel& getTimers() const { return timers; }
+    
     // Getters
     float getDeltaTime() const { return deltaTime; }
     float getFPS() const { return fps; }
-    float getAverageFrameTime() const;
+    float getAverageFrameTime() const { return frameStats.getAverage(); }
+    // Standard deviation of recent frame times, in seconds
+    float getFrameTimeJitter() const { return frameStats.getStdDev(); }
+    // Percentiles, lows and over-budget counts for recent frames
+    const FrameStats& getFrameStats() const { return frameStats; }
+    FrameStats& getFrameStats() { return frameStats; }
+    // Learned amount the OS oversleeps by, in seconds
+    float getOversleepEstimate() const;
     unsigned int getFrameCount() const { return frameCount; }
     float getTotalTime() const { return totalTime; }
     int getTargetFPS() const { return targetFPS; }
     
+    bool isFixedTimestep() const { return fixedDeltaTime > 0.0f; }
+    float getFixedDeltaTime() const { return fixedDeltaTime; }
+    // How far the current time is between the last two fixed steps (0..1)
+    float getInterpolationAlpha() const;
+    unsigned int getFixedStepCount() const { return fixedStepCount; }
+    unsigned int getDroppedStepCount() const { return droppedStepCount; }
+
 private:
-    using Clock = std::chrono::high_resolution_clock;
-    using TimePoint = std::chrono::time_point<Clock>;
+    using TimePoint = Clock::TimePoint;
     
+    void finishPerfFrame();
+    
+    std::unique_ptr<Clock> clock;
     int targetFPS;
-    float targetFrameTime;
+    
+    // Frame limiter state
+    Clock::Duration frameDuration;
+    TimePoint frameDeadline;
+    Clock::Duration oversleepEstimate;
     
     TimePoint lastTime;
     TimePoint currentTime;
@@ -41,9 +99,27 @@ private:
     float fpsTimer;
     unsigned int fpsFrameCount;
     
+    // Fixed-step state
+    float fixedDeltaTime;
+    int maxStepsPerFrame;
+    float accumulator;
+    int stepsThisFrame;
+    unsigned int fixedStepCount;
+    unsigned int droppedStepCount;
+    
     // Frame time history
-    std::deque<float> frameTimes;
-    static const size_t MAX_FRAME_HISTORY = 60;
+    FrameStats frameStats;
+    
+    TimerWheel timers;
+    
+    // Hardware counters, null unless enabled
+    PerfCounters* perfCounters;
+    PerfCounterValues frameStartCounters;
+    PerfCounterValues frameCounters;
+    PerfCounterValues averageFrameCounters;
+    PerfCounterValues perfIntervalTotals;
+    unsigned int perfIntervalFrames;
+    bool perfFrameFinished;
 };
 
 } // namespace ENGAIN
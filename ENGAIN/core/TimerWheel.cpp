@@ -0,0 +1,318 @@
+#include "TimerWheel.h"
+#include <algorithm>
+#include <cmath>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace ENGAIN {
+
+namespace {
+    // Longest delay the four levels can hold
+    const uint64_t MAX_DELAY_TICKS = 0xFFFFFFFFull;
+    
+    int lowestBit(uint64_t bits) {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward64(&index, bits);
+        return static_cast<int>(index);
+#else
+        return __builtin_ctzll(bits);
+#endif
+    }
+}
+
+TimerWheel::TimerWheel(float tickDuration)
+    : tickDuration(tickDuration > 0.0f ? tickDuration : 0.001f),
+      elapsed(0.0),
+      currentTick(0),
+      freeList(NONE),
+      pendingCount(0),
+      heads(LEVELS * SLOTS + 1, NONE) {
+    std::fill(occupied, occupied + SLOTS / 64, 0);
+}
+
+TimerHandle TimerWheel::schedule(float delay, Callback callback, const void* owner) {
+    return add(delay, false, std::move(callback), 0, owner);
+}
+
+TimerHandle TimerWheel::scheduleRepeating(float interval, Callback callback, const void* owner) {
+    return add(interval, true, std::move(callback), 0, owner);
+}
+
+TimerHandle TimerWheel::scheduleEvent(float delay, uint32_t eventId, const void* owner) {
+    return add(delay, false, Callback(), eventId, owner);
+}
+
+TimerHandle TimerWheel::add(float delay, bool repeating, Callback callback, uint32_t eventId, const void* owner) {
+    uint32_t index = allocate();
+    Node& node = nodes[index];
+    uint64_t ticks = toTicks(delay);
+    node.expiry = currentTick + ticks;
+    node.interval = repeating ? ticks : 0;
+    node.owner = owner;
+    node.eventId = eventId;
+    node.callback = std::move(callback);
+    
+    node.ownerPrev = NONE;
+    node.ownerNext = NONE;
+    if (owner) {
+        auto result = ownerHeads.emplace(owner, index);
+        if (!result.second) {
+            uint32_t head = result.first->second;
+            node.ownerNext = head;
+            nodes[head].ownerPrev = index;
+            result.first->second = index;
+        }
+    }
+    
+    insert(index, currentTick);
+    pendingCount++;
+    return TimerHandle(index, node.generation);
+}
+
+uint64_t TimerWheel::toTicks(float seconds) const {
+    // Round up so a timer never fires early, and always wait at least a tick
+    double ticks = std::ceil(seconds / tickDuration - 1e-6);
+    if (ticks < 1.0) return 1;
+    if (ticks > static_cast<double>(MAX_DELAY_TICKS)) return MAX_DELAY_TICKS;
+    return static_cast<uint64_t>(ticks);
+}
+
+uint32_t TimerWheel::allocate() {
+    if (freeList != NONE) {
+        uint32_t index = freeList;
+        freeList = nodes[index].next;
+        return index;
+    }
+    
+    nodes.emplace_back();
+    nodes.back().generation = 1;
+    nodes.back().list = NONE;
+    return static_cast<uint32_t>(nodes.size() - 1);
+}
+
+void TimerWheel::release(uint32_t index) {
+    Node& node = nodes[index];
+    
+    if (node.owner) {
+        if (node.ownerPrev != NONE) {
+            nodes[node.ownerPrev].ownerNext = node.ownerNext;
+        } else if (node.ownerNext != NONE) {
+            ownerHeads[node.owner] = node.ownerNext;
+        } else {
+            ownerHeads.erase(node.owner);
+        }
+        if (node.ownerNext != NONE) {
+            nodes[node.ownerNext].ownerPrev = node.ownerPrev;
+        }
+        node.owner = nullptr;
+    }
+    
+    node.callback = nullptr;
+    node.list = NONE;
+    node.generation = node.generation + 1 != 0 ? node.generation + 1 : 1;
+    node.next = freeList;
+    freeList = index;
+    pendingCount--;
+}
+
+void TimerWheel::insert(uint32_t index, uint64_t base) {
+    Node& node = nodes[index];
+    
+    // The level is the highest byte in which the expiry differs from the
+    // base; the slot is the expiry's value in that byte
+    uint64_t difference = node.expiry ^ base;
+    int level = 0;
+    while (level < LEVELS - 1 && difference >= (1ull << ((level + 1) * SLOT_BITS))) {
+        level++;
+    }
+    uint32_t slot = static_cast<uint32_t>((node.expiry >> (level * SLOT_BITS)) & SLOT_MASK);
+    uint32_t list = level * SLOTS + slot;
+    
+    node.list = list;
+    node.prev = NONE;
+    node.next = heads[list];
+    if (node.next != NONE) {
+        nodes[node.next].prev = index;
+    }
+    heads[list] = index;
+    
+    if (level == 0) {
+        occupied[slot / 64] |= 1ull << (slot % 64);
+    }
+}
+
+void TimerWheel::unlink(uint32_t index) {
+    Node& node = nodes[index];
+    if (node.prev != NONE) {
+        nodes[node.prev].next = node.next;
+    } else {
+        heads[node.list] = node.next;
+        if (node.next == NONE && node.list < SLOTS) {
+            occupied[node.list / 64] &= ~(1ull << (node.list % 64));
+        }
+    }
+    if (node.next != NONE) {
+        nodes[node.next].prev = node.prev;
+    }
+}
+
+bool TimerWheel::cancel(TimerHandle handle) {
+    if (!isPending(handle)) return false;
+    
+    unlink(handle.index);
+    release(handle.index);
+    return true;
+}
+
+size_t TimerWheel::cancelOwner(const void* owner) {
+    size_t cancelled = 0;
+    auto found = ownerHeads.find(owner);
+    while (found != ownerHeads.end()) {
+        uint32_t index = found->second;
+        unlink(index);
+        release(index);
+        cancelled++;
+        found = ownerHeads.find(owner);
+    }
+    return cancelled;
+}
+
+void TimerWheel::clear() {
+    for (uint32_t index = 0; index < nodes.size(); index++) {
+        if (nodes[index].list != NONE) {
+            unlink(index);
+            release(index);
+        }
+    }
+}
+
+bool TimerWheel::isPending(TimerHandle handle) const {
+    return handle.index < nodes.size() &&
+           nodes[handle.index].generation == handle.generation &&
+           nodes[handle.index].list != NONE;
+}
+
+float TimerWheel::getRemaining(TimerHandle handle) const {
+    if (!isPending(handle)) return 0.0f;
+    
+    double remaining = nodes[handle.index].expiry * tickDuration - elapsed;
+    return remaining > 0.0 ? static_cast<float>(remaining) : 0.0f;
+}
+
+void TimerWheel::advance(float seconds) {
+    expiredEvents.clear();
+    if (seconds <= 0.0f) return;
+    
+    elapsed += seconds;
+    uint64_t target = static_cast<uint64_t>(elapsed / tickDuration + 1e-6);
+    
+    while (currentTick < target) {
+        uint64_t tick = currentTick + 1;
+        
+        // Crossing into a new level 0 rotation: pull down the timers that
+        // fall inside it, highest level first
+        if ((tick & SLOT_MASK) == 0) {
+            for (int level = LEVELS - 1; level >= 1; level--) {
+                uint64_t lowerBits = (1ull << (level * SLOT_BITS)) - 1;
+                if ((tick & lowerBits) == 0) {
+                    cascade(level, tick);
+                }
+            }
+        }
+        
+        // Jump straight to the next occupied slot in this rotation
+        uint64_t last = std::min(target, tick | SLOT_MASK);
+        int slot = findOccupied(static_cast<uint32_t>(tick & SLOT_MASK),
+                                static_cast<uint32_t>(last & SLOT_MASK));
+        if (slot < 0) {
+            currentTick = last;
+            continue;
+        }
+        
+        currentTick = (tick & ~SLOT_MASK) | static_cast<uint64_t>(slot);
+        fireSlot(static_cast<uint32_t>(slot));
+    }
+}
+
+void TimerWheel::cascade(int level, uint64_t tick) {
+    uint32_t list = level * SLOTS + static_cast<uint32_t>((tick >> (level * SLOT_BITS)) & SLOT_MASK);
+    uint32_t index = heads[list];
+    heads[list] = NONE;
+    
+    while (index != NONE) {
+        uint32_t next = nodes[index].next;
+        insert(index, tick);
+        index = next;
+    }
+}
+
+void TimerWheel::fireSlot(uint32_t slot) {
+    // Move the slot to its own list first, so callbacks can cancel timers
+    // that are due on the same tick
+    uint32_t index = heads[slot];
+    heads[slot] = NONE;
+    occupied[slot / 64] &= ~(1ull << (slot % 64));
+    heads[FIRING_LIST] = index;
+    for (; index != NONE; index = nodes[index].next) {
+        nodes[index].list = FIRING_LIST;
+    }
+    
+    while (heads[FIRING_LIST] != NONE) {
+        index = heads[FIRING_LIST];
+        unlink(index);
+        fire(index);
+    }
+}
+
+void TimerWheel::fire(uint32_t index) {
+    Node& node = nodes[index];
+    TimerHandle handle(index, node.generation);
+    
+    if (!node.callback) {
+        expiredEvents.push_back(TimerEvent{handle, node.owner, node.eventId});
+        if (node.interval > 0) {
+            node.expiry += node.interval;
+            insert(index, currentTick);
+        } else {
+            release(index);
+        }
+        return;
+    }
+    
+    Callback callback = std::move(node.callback);
+    if (node.interval > 0) {
+        node.expiry += node.interval;
+        insert(index, currentTick);
+        callback();
+        
+        // Still scheduled unless the callback cancelled it; the node array
+        // may have grown, so index it again
+        if (isPending(handle)) {
+            nodes[index].callback = std::move(callback);
+        }
+    } else {
+        release(index);
+        callback();
+    }
+}
+
+int TimerWheel::findOccupied(uint32_t from, uint32_t to) const {
+    for (uint32_t word = from / 64; word <= to / 64; word++) {
+        uint64_t bits = occupied[word];
+        if (word == from / 64) {
+            bits &= ~0ull << (from % 64);
+        }
+        if (word == to / 64 && to % 64 != 63) {
+            bits &= (2ull << (to % 64)) - 1;
+        }
+        if (bits) {
+            return static_cast<int>(word * 64) + lowestBit(bits);
+        }
+    }
+    return -1;
+}
+
+} // namespace ENGAIN
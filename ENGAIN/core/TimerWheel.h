@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace ENGAIN {
+
+// Identifies a scheduled timer. Handles go stale once their timer fires or
+// is cancelled, so holding on to one is always safe.
+struct TimerHandle {
+    uint32_t index;
+    uint32_t generation;    // 0 for a handle that never referred to a timer
+    
+    TimerHandle() : index(0), generation(0) {}
+    TimerHandle(uint32_t index, uint32_t generation) : index(index), generation(generation) {}
+    
+    bool isNull() const { return generation == 0; }
+};
+
+// Reported for timers scheduled with scheduleEvent()
+struct TimerEvent {
+    TimerHandle handle;
+    const void* owner;
+    uint32_t eventId;
+};
+
+// Hierarchical timing wheel: four levels of 256 slots over a fixed tick
+// (1 ms by default). Scheduling and cancelling are O(1); advancing costs
+// the timers that expire plus an occasional cascade of one slot into the
+// level below, so idle timers are never touched. Timers live in a pooled
+// node array linked through indices, and can be tagged with an owner to
+// cancel every timer of an entity at once. Delays are capped at 2^32 ticks.
+class TimerWheel {
+public:
+    using Callback = std::function<void()>;
+    
+    explicit TimerWheel(float tickDuration = 0.001f);
+    
+    // Run callback once, delay seconds from now. Callbacks may schedule and
+    // cancel timers, including their own.
+    TimerHandle schedule(float delay, Callback callback, const void* owner = nullptr);
+    // Run callback every interval seconds until cancelled
+    TimerHandle scheduleRepeating(float interval, Callback callback, const void* owner = nullptr);
+    // Report a TimerEvent from getExpiredEvents() instead of calling back
+    TimerHandle scheduleEvent(float delay, uint32_t eventId, const void* owner = nullptr);
+    
+    bool cancel(TimerHandle handle);
+    // Cancel every pending timer tagged with owner
+    size_t cancelOwner(const void* owner);
+    void clear();
+    
+    bool isPending(TimerHandle handle) const;
+    // Seconds until the timer fires, 0 if it is not pending
+    float getRemaining(TimerHandle handle) const;
+    
+    // Move time forward, firing everything that expires on the way in order
+    void advance(float seconds);
+    // Events that expired during the last advance()
+    const std::vector<TimerEvent>& getExpiredEvents() const { return expiredEvents; }
+    
+    size_t getPendingCount() const { return pendingCount; }
+    double getTime() const { return elapsed; }
+    float getTickDuration() const { return static_cast<float>(tickDuration); }
+
+private:
+    static const int LEVELS = 4;
+    static const int SLOT_BITS = 8;
+    static const uint32_t SLOTS = 1u << SLOT_BITS;
+    static const uint64_t SLOT_MASK = SLOTS - 1;
+    static constexpr uint32_t NONE = 0xFFFFFFFFu;
+    // List that holds the timers of the slot being fired
+    static const uint32_t FIRING_LIST = LEVELS * SLOTS;
+    
+    struct Node {
+        uint64_t expiry;      // Tick the timer fires on
+        uint64_t interval;    // Ticks between repeats, 0 for one-shot timers
+        uint32_t prev;
+        uint32_t next;        // Also links the free list
+        uint32_t list;        // Slot list the node is in, NONE when free
+        uint32_t generation;
+        uint32_t ownerPrev;
+        uint32_t ownerNext;
+        const void* owner;
+        uint32_t eventId;
+        Callback callback;
+    };
+    
+    TimerHandle add(float delay, bool repeating, Callback callback, uint32_t eventId, const void* owner);
+    uint64_t toTicks(float seconds) const;
+    uint32_t allocate();
+    void release(uint32_t index);
+    void insert(uint32_t index, uint64_t base);
+    void unlink(uint32_t index);
+    void cascade(int level, uint64_t tick);
+    void fireSlot(uint32_t slot);
+    void fire(uint32_t index);
+    int findOccupied(uint32_t from, uint32_t to) const;
+    
+    double tickDuration;
+    double elapsed;
+    uint64_t currentTick;
+    
+    std::vector<Node> nodes;
+    uint32_t freeList;
+    size_t pendingCount;
+    
+    // Slot list heads for every level, plus the firing list
+    std::vector<uint32_t> heads;
+    // Non-empty slots of level 0, so advancing skips empty ticks
+    uint64_t occupied[SLOTS / 64];
+    
+    std::unordered_map<const void*, uint32_t> ownerHeads;
+    std::vector<TimerEvent> expiredEvents;
+};
+
+} // namespace ENGAIN
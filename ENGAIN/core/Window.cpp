@@ -1,19 +1,36 @@
 #include "Window.h"
 #include "Logger.h"
-#include <sstream>
+#include "BinaryLog.h"
+#include "LogThrottle.h"
+#include "Profiler.h"
+#include "PerfCounters.h"
+#include "EventDispatcher.h"
+#include <chrono>
+#include <utility>
 
 namespace ENGAIN {
 
-Window::Window(const std::string& title, int width, int height, bool resizable)
-    : title(title),
-      width(width),
-      height(height),
-      resizable(resizable),
+Window::Window(const std::string& title, int width, int height, bool resizable, WindowMode mode)
+    : Window(WindowConfig(title, width, height, resizable)) {
+    config.mode = mode;
+}
+
+Window::Window(const WindowConfig& config)
+    : config(config),
+      title(config.title),
+      width(config.width),
+      height(config.height),
       running(false),
       focused(true),
       initialized(false),
       window(nullptr),
-      renderer(nullptr) {
+      renderer(nullptr),
+      surface(nullptr),
+      backgroundValid(false),
+      frameCleared(false),
+      partialFrames(0),
+      fullFrames(0),
+      presentedCoverage(0.0) {
 }
 
 Window::~Window() {
@@ -23,21 +40,31 @@ Window::~Window() {
 bool Window::initialize() {
     if (initialized) return true;
     
+    bool headless = config.mode == WindowMode::HEADLESS;
+    
+    // SDL_VIDEODRIVER from the environment still wins, e.g. "offscreen"
+    if (headless) {
+        SDL_SetHint(SDL_HINT_VIDEODRIVER, "dummy");
+    }
+    
     // Initialize SDL
     if (SDL_Init(SDL_INIT_VIDEO) < 0) {
-        std::ostringstream oss;
-        oss << "SDL initialization failed: " << SDL_GetError();
-        Logger::getInstance().error(oss.str());
+        ENGAIN_LOG_ERROR(WINDOW, "SDL initialization failed: " << SDL_GetError());
         return false;
     }
     
-    Logger::getInstance().info("SDL initialized");
+    ENGAIN_LOG_INFO(WINDOW, "SDL initialized");
     
     // Create window
-    Uint32 flags = SDL_WINDOW_SHOWN;
-    if (resizable) {
+    Uint32 flags = headless ? SDL_WINDOW_HIDDEN : SDL_WINDOW_SHOWN;
+    if (config.resizable && !headless) {
         flags |= SDL_WINDOW_RESIZABLE;
     }
+    if (!headless && config.fullscreen == FullscreenMode::EXCLUSIVE) {
+        flags |= SDL_WINDOW_FULLSCREEN;
+    } else if (!headless && config.fullscreen == FullscreenMode::DESKTOP) {
+        flags |= SDL_WINDOW_FULLSCREEN_DESKTOP;
+    }
     
     window = SDL_CreateWindow(
         title.c_str(),
@@ -49,32 +76,48 @@ bool Window::initialize() {
     );
     
     if (!window) {
-        std::ostringstream oss;
-        oss << "Window creation failed: " << SDL_GetError();
-        Logger::getInstance().error(oss.str());
+        ENGAIN_LOG_ERROR(WINDOW, "Window creation failed: " << SDL_GetError());
         SDL_Quit();
         return false;
     }
     
-    // Create renderer
-    renderer = SDL_CreateRenderer(
-        window,
-        -1,
-        SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC
-    );
+    // Fullscreen windows take the size of the display mode
+    if (!headless) {
+        SDL_GetWindowSize(window, &width, &height);
+    }
     
-    if (!renderer) {
-        std::ostringstream oss;
-        oss << "Renderer creation failed: " << SDL_GetError();
-        Logger::getInstance().error(oss.str());
+    if (!createRenderer()) {
+        if (surface) {
+            SDL_FreeSurface(surface);
+            surface = nullptr;
+        }
         SDL_DestroyWindow(window);
+        window = nullptr;
         SDL_Quit();
         return false;
     }
     
-    std::ostringstream oss;
-    oss << "Window created: " << width << "x" << height << " - '" << title << "'";
-    Logger::getInstance().info(oss.str());
+    if (headless) {
+        ENGAIN_LOG_INFO(WINDOW, "Headless window created: " << width << "x" << height << " on video driver '"
+                        << SDL_GetCurrentVideoDriver() << "' - '" << title << "'");
+    } else {
+        ENGAIN_LOG_INFO(WINDOW, "Window created: " << width << "x" << height << " - '" << title << "'");
+    }
+    
+    setupLatency();
+    
+    if (config.dirtyRects) {
+        resetDirtyRects();
+        ENGAIN_LOG_INFO(RENDER, "Dirty-rect presentation enabled");
+    }
+    
+    // Window state follows the shared event stream
+    EventDispatcher& events = EventDispatcher::getInstance();
+    events.initialize();
+    auto listener = [this](const SDL_Event& event) { handleEvent(event); };
+    eventListeners.push_back(events.subscribe(SDL_QUIT, listener));
+    eventListeners.push_back(events.subscribe(SDL_WINDOWEVENT, listener));
+    eventListeners.push_back(events.subscribe(SDL_KEYDOWN, listener));
     
     initialized = true;
     running = true;
@@ -82,67 +125,325 @@ bool Window::initialize() {
     return true;
 }
 
+bool Window::createRenderer() {
+    // Hints only affect renderers and textures created after them
+    SDL_SetHint(SDL_HINT_RENDER_BATCHING, config.batching ? "1" : "0");
+    SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, config.scaleQuality.c_str());
+    
+    if (config.mode == WindowMode::HEADLESS) {
+        // Draw on the CPU into our own surface; present() never waits
+        surface = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_ARGB8888);
+        if (surface) {
+            renderer = SDL_CreateSoftwareRenderer(surface);
+        }
+    } else {
+        // Partial presentation updates the window surface the software
+        // renderer draws into; other renderers can only present everything
+        if (config.dirtyRects && config.renderDriver != "software") {
+            if (!config.renderDriver.empty()) {
+                ENGAIN_LOG_WARNING(RENDER, "Dirty rects need the software renderer, ignoring '"
+                                   << config.renderDriver << "'");
+            }
+            config.renderDriver = "software";
+        }
+        
+        int driverIndex = -1;
+        if (!config.renderDriver.empty()) {
+            std::vector<std::string> drivers = getRenderDrivers();
+            for (size_t i = 0; i < drivers.size(); i++) {
+                if (drivers[i] == config.renderDriver) {
+                    driverIndex = static_cast<int>(i);
+                    break;
+                }
+            }
+            if (driverIndex < 0) {
+                ENGAIN_LOG_WARNING(RENDER, "Render driver '" << config.renderDriver
+                                   << "' not available, letting SDL choose");
+            }
+        }
+        
+        Uint32 rendererFlags = config.renderDriver == "software" ? SDL_RENDERER_SOFTWARE : SDL_RENDERER_ACCELERATED;
+        if (config.vsync != VSyncMode::OFF) {
+            rendererFlags |= SDL_RENDERER_PRESENTVSYNC;
+        }
+        renderer = SDL_CreateRenderer(window, driverIndex, rendererFlags);
+        
+        // No GPU: still show something
+        if (!renderer && !(rendererFlags & SDL_RENDERER_SOFTWARE)) {
+            ENGAIN_LOG_WARNING(RENDER, "Accelerated renderer creation failed: " << SDL_GetError()
+                               << " - falling back to software");
+            renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_SOFTWARE);
+        }
+    }
+    
+    if (!renderer) {
+        ENGAIN_LOG_ERROR(RENDER, "Renderer creation failed: " << SDL_GetError());
+        return false;
+    }
+    
+    if (config.mode != WindowMode::HEADLESS) {
+        applyVSync();
+    }
+    
+    SDL_RendererInfo info;
+    if (SDL_GetRendererInfo(renderer, &info) == 0) {
+        rendererName = info.name;
+        ENGAIN_LOG_INFO(RENDER, "Renderer: " << info.name
+                        << ((info.flags & SDL_RENDERER_ACCELERATED) ? ", accelerated" : ", software")
+                        << ((info.flags & SDL_RENDERER_PRESENTVSYNC) ? ", vsync" : ", no vsync")
+                        << ", batching " << (config.batching ? "on" : "off")
+                        << ", scale quality " << config.scaleQuality
+                        << ", max texture " << info.max_texture_width << "x" << info.max_texture_height
+                        << " (video driver " << SDL_GetCurrentVideoDriver() << ")");
+    }
+    
+    return true;
+}
+
+void Window::applyVSync() {
+    if (config.vsync != VSyncMode::ADAPTIVE) return;
+    
+    // SDL's renderer API only knows on and off; the GL renderers make their
+    // context current, so the swap interval can be set directly
+    SDL_RendererInfo info;
+    bool openGL = SDL_GetRendererInfo(renderer, &info) == 0 &&
+                  std::string(info.name).compare(0, 6, "opengl") == 0;
+    if (openGL && SDL_GL_SetSwapInterval(-1) == 0) {
+        ENGAIN_LOG_INFO(RENDER, "Adaptive vsync enabled");
+    } else {
+        ENGAIN_LOG_INFO(RENDER, "Adaptive vsync not supported by this renderer, using vsync");
+    }
+}
+
+void Window::setupLatency() {
+    // Present waits for the display only with vsync
+    SDL_DisplayMode displayMode;
+    bool waitsForVSync = config.mode != WindowMode::HEADLESS && config.vsync != VSyncMode::OFF;
+    if (waitsForVSync && SDL_GetWindowDisplayMode(window, &displayMode) == 0 && displayMode.refresh_rate > 0) {
+        latency.setRefreshPeriod(1.0 / displayMode.refresh_rate);
+    }
+    
+    if (!config.lowLatency) return;
+    if (latency.getRefreshPeriod() > 0.0) {
+        latency.setLowLatency(true);
+        ENGAIN_LOG_INFO(RENDER, "Low-latency mode enabled, display refresh "
+                        << latency.getRefreshPeriod() * 1000.0 << " ms");
+    } else {
+        ENGAIN_LOG_WARNING(RENDER, "Low-latency mode needs vsync and a known display refresh rate, "
+                           "input is sampled at the start of the frame");
+    }
+}
+
+std::vector<std::string> Window::getRenderDrivers() {
+    std::vector<std::string> drivers;
+    int count = SDL_GetNumRenderDrivers();
+    for (int i = 0; i < count; i++) {
+        SDL_RendererInfo info;
+        drivers.push_back(SDL_GetRenderDriverInfo(i, &info) == 0 ? info.name : "");
+    }
+    return drivers;
+}
+
 void Window::handleEvents() {
-    SDL_Event event;
+    latency.waitForFrameStart();
     
-    while (SDL_PollEvent(&event)) {
-        switch (event.type) {
-            case SDL_QUIT:
-                running = false;
-                Logger::getInstance().info("Window close requested");
-                break;
+    ENGAIN_PERF_SCOPE("Window::handleEvents");
+    EventDispatcher& events = EventDispatcher::getInstance();
+    FrameLatency::TimePoint pumpTime = std::chrono::steady_clock::now();
+    events.pump();
+    latency.onEventsPumped(pumpTime, events.getFrameEvents());
+}
+
+void Window::handleEvent(const SDL_Event& event) {
+    switch (event.type) {
+        case SDL_QUIT:
+            running = false;
+            ENGAIN_LOG_INFO(WINDOW, "Window close requested");
+            break;
+        
+        case SDL_WINDOWEVENT:
+            switch (event.window.event) {
+                case SDL_WINDOWEVENT_RESIZED:
+                    // The headless surface keeps its size
+                    if (surface) break;
+                    width = event.window.data1;
+                    height = event.window.data2;
+                    ENGAIN_LOGF_DEBUG(WINDOW, "Window resized to {}x{}", width, height);
+                    if (config.dirtyRects) {
+                        resetDirtyRects();
+                    }
+                    break;
                 
-            case SDL_WINDOWEVENT:
-                switch (event.window.event) {
-                    case SDL_WINDOWEVENT_RESIZED:
-                        width = event.window.data1;
-                        height = event.window.data2;
-                        {
-                            std::ostringstream oss;
-                            oss << "Window resized to " << width << "x" << height;
-                            Logger::getInstance().debug(oss.str());
-                        }
-                        break;
-                        
-                    case SDL_WINDOWEVENT_FOCUS_GAINED:
-                        focused = true;
-                        Logger::getInstance().debug("Window gained focus");
-                        break;
-                        
-                    case SDL_WINDOWEVENT_FOCUS_LOST:
-                        focused = false;
-                        Logger::getInstance().debug("Window lost focus");
-                        break;
-                }
-                break;
+                case SDL_WINDOWEVENT_EXPOSED:
+                    // Parts of the window may show garbage until redrawn
+                    backgroundValid = false;
+                    break;
                 
-            case SDL_KEYDOWN:
-                if (event.key.keysym.sym == SDLK_ESCAPE) {
-                    running = false;
-                    Logger::getInstance().info("ESC pressed - closing window");
-                }
-                break;
-        }
+                case SDL_WINDOWEVENT_FOCUS_GAINED:
+                    focused = true;
+                    ENGAIN_LOG_DEBUG(WINDOW, "Window gained focus");
+                    break;
+                
+                case SDL_WINDOWEVENT_FOCUS_LOST:
+                    focused = false;
+                    ENGAIN_LOG_DEBUG(WINDOW, "Window lost focus");
+                    break;
+            }
+            break;
+        
+        case SDL_KEYDOWN:
+            if (event.key.keysym.sym == SDLK_ESCAPE) {
+                running = false;
+                ENGAIN_LOG_INFO(INPUT, "ESC pressed - closing window");
+            }
+            break;
     }
 }
 
 void Window::clear(const Color& color) {
-    if (renderer) {
-        SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
-        SDL_RenderClear(renderer);
+    ENGAIN_PROFILE_SCOPE("Window::clear");
+    if (!renderer) return;
+    
+    SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
+    
+    bool sameColor = color.r == clearColor.r && color.g == clearColor.g &&
+                     color.b == clearColor.b && color.a == clearColor.a;
+    if (config.dirtyRects && backgroundValid && sameColor && !drawnLast.isFull()) {
+        // Everything outside last frame's drawing still shows the background
+        const std::vector<SDL_Rect>& rects = drawnLast.getRects();
+        if (!rects.empty()) {
+            SDL_BlendMode blendMode;
+            SDL_GetRenderDrawBlendMode(renderer, &blendMode);
+            SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+            SDL_RenderFillRects(renderer, rects.data(), static_cast<int>(rects.size()));
+            SDL_SetRenderDrawBlendMode(renderer, blendMode);
+        }
+        return;
     }
+    
+    SDL_RenderClear(renderer);
+    clearColor = color;
+    backgroundValid = true;
+    frameCleared = true;
 }
 
 void Window::present() {
+    ENGAIN_PROFILE_SCOPE("Window::present");
+    if (renderer) {
+        latency.onPresentStart(std::chrono::steady_clock::now());
+        if (capture) {
+            capture->onFrame(renderer);
+        }
+        if (config.dirtyRects) {
+            presentDirtyRects();
+        } else {
+            SDL_RenderPresent(renderer);
+        }
+        latency.onPresented(std::chrono::steady_clock::now());
+    }
+}
+
+void Window::markDirty(const SDL_Rect& rect) {
+    if (config.dirtyRects) {
+        drawn.add(rect);
+    }
+}
+
+void Window::markAllDirty() {
+    if (config.dirtyRects) {
+        drawn.addAll();
+    }
+}
+
+void Window::resetDirtyRects() {
+    int outputWidth = width;
+    int outputHeight = height;
     if (renderer) {
+        SDL_GetRendererOutputSize(renderer, &outputWidth, &outputHeight);
+    }
+    
+    drawn.setBounds(outputWidth, outputHeight);
+    drawnLast.setBounds(outputWidth, outputHeight);
+    presented.setBounds(outputWidth, outputHeight);
+    drawn.clear();
+    
+    // The next clear() has to cover the whole new surface
+    backgroundValid = false;
+}
+
+void Window::presentDirtyRects() {
+    // Pixels that changed: last frame's drawing was erased, this frame's added
+    presented.clear();
+    if (frameCleared) {
+        presented.addAll();
+    } else {
+        for (const SDL_Rect& rect : drawnLast.getRects()) {
+            presented.add(rect);
+        }
+        for (const SDL_Rect& rect : drawn.getRects()) {
+            presented.add(rect);
+        }
+    }
+    
+    if (presented.isFull()) {
+        fullFrames++;
+    } else {
+        partialFrames++;
+    }
+    presentedCoverage += presented.getCoverage();
+    
+    if (surface) {
+        // Headless: the surface is the result, it only has to be up to date
+        SDL_RenderFlush(renderer);
+    } else if (presented.isFull()) {
         SDL_RenderPresent(renderer);
+    } else {
+        // SDL_RenderPresent would copy the whole window surface
+        SDL_RenderFlush(renderer);
+        const std::vector<SDL_Rect>& rects = presented.getRects();
+        if (!rects.empty() &&
+            SDL_UpdateWindowSurfaceRects(window, rects.data(), static_cast<int>(rects.size())) != 0) {
+            ENGAIN_LOG_THROTTLED(LogLevel::WARNING, RENDER, 1, 5.0f, "Updating window rects failed: " << SDL_GetError());
+        }
     }
+    
+    std::swap(drawn, drawnLast);
+    drawn.clear();
+    frameCleared = false;
 }
 
 void Window::close() {
+    // Finishes writing queued frames
+    capture.reset();
+    
+    unsigned long long frames = partialFrames + fullFrames;
+    if (config.dirtyRects && frames > 0) {
+        ENGAIN_LOG_INFO(RENDER, "Dirty rects: " << partialFrames << " partial and " << fullFrames
+                        << " full presents, " << (presentedCoverage * 100.0 / frames)
+                        << "% of the screen updated on average");
+        partialFrames = 0;
+        fullFrames = 0;
+        presentedCoverage = 0.0;
+    }
+    
+    if (latency.getLatencyStats().getSampleCount() > 0) {
+        latency.logReport();
+    }
+    
+    for (EventListenerId id : eventListeners) {
+        EventDispatcher::getInstance().unsubscribe(id);
+    }
+    eventListeners.clear();
+    
     if (renderer) {
         SDL_DestroyRenderer(renderer);
         renderer = nullptr;
+        rendererName.clear();
+    }
+    
+    if (surface) {
+        SDL_FreeSurface(surface);
+        surface = nullptr;
     }
     
     if (window) {
@@ -151,12 +452,67 @@ void Window::close() {
     }
     
     if (initialized) {
+        EventDispatcher::getInstance().shutdown();
         SDL_Quit();
-        Logger::getInstance().info("Window closed");
+        ENGAIN_LOG_INFO(WINDOW, "Window closed");
         initialized = false;
     }
 }
 
+bool Window::saveFrame(const std::string& path) {
+    if (!renderer) return false;
+    
+    SDL_Surface* frame = surface;
+    if (frame) {
+        // Draw calls may still be batched
+        SDL_RenderFlush(renderer);
+    } else {
+        int outputWidth = 0;
+        int outputHeight = 0;
+        SDL_GetRendererOutputSize(renderer, &outputWidth, &outputHeight);
+        frame = SDL_CreateRGBSurfaceWithFormat(0, outputWidth, outputHeight, 32, SDL_PIXELFORMAT_ARGB8888);
+        if (!frame || SDL_RenderReadPixels(renderer, nullptr, SDL_PIXELFORMAT_ARGB8888,
+                                           frame->pixels, frame->pitch) != 0) {
+            ENGAIN_LOG_ERROR(RENDER, "Reading frame failed: " << SDL_GetError());
+            if (frame) SDL_FreeSurface(frame);
+            return false;
+        }
+    }
+    
+    bool saved = SDL_SaveBMP(frame, path.c_str()) == 0;
+    if (frame != surface) {
+        SDL_FreeSurface(frame);
+    }
+    
+    if (!saved) {
+        ENGAIN_LOG_ERROR(RENDER, "Saving frame to " << path << " failed: " << SDL_GetError());
+        return false;
+    }
+    ENGAIN_LOG_INFO(RENDER, "Saved frame to " << path);
+    return true;
+}
+
+bool Window::startCapture(const FrameCaptureConfig& config) {
+    capture.reset(new FrameCapture(config));
+    if (!capture->start()) {
+        capture.reset();
+        return false;
+    }
+    return true;
+}
+
+void Window::stopCapture() {
+    capture.reset();
+}
+
+void Window::takeScreenshot(const std::string& path) {
+    // Screenshots alone need no recording set up
+    if (!capture) {
+        capture.reset(new FrameCapture());
+    }
+    capture->requestScreenshot(path);
+}
+
 void Window::setTitle(const std::string& newTitle) {
     title = newTitle;
     if (window) {
@@ -3,6 +3,11 @@
 #include <SDL2/SDL.h>
 #include <string>
 #include <memory>
+#include <vector>
+#include "EventDispatcher.h"
+#include "FrameCapture.h"
+#include "DirtyRegion.h"
+#include "FrameLatency.h"
 
 namespace ENGAIN {
 
@@ -13,37 +18,128 @@ struct Color {
         : r(r), g(g), b(b), a(a) {}
 };
 
+enum class WindowMode {
+    WINDOWED,   // Visible window with the configured renderer
+    HEADLESS    // No display needed: dummy video driver, software renderer into a surface
+};
+
+enum class VSyncMode {
+    OFF,
+    ON,
+    ADAPTIVE    // Tear instead of waiting when a frame is late; OpenGL only, else ON
+};
+
+enum class FullscreenMode {
+    WINDOWED,
+    EXCLUSIVE,  // Changes the display mode to the window size
+    DESKTOP     // Borderless at the desktop resolution
+};
+
+struct WindowConfig {
+    std::string title;
+    int width;
+    int height;
+    bool resizable;
+    WindowMode mode;
+    FullscreenMode fullscreen;
+    
+    // SDL render driver name ("opengl", "opengles2", "software", ...),
+    // empty to let SDL pick the best one
+    std::string renderDriver;
+    VSyncMode vsync;
+    // Let SDL queue draw calls and submit them in batches
+    bool batching;
+    // Texture filtering when scaling: "nearest", "linear" or "best"
+    std::string scaleQuality;
+    // Clear and present only the rectangles passed to markDirty(). Needs a
+    // software renderer, which windowed mode then selects.
+    bool dirtyRects;
+    // Delay event pumping, and so input sampling and simulation, until just
+    // before the next vblank. Needs vsync; see FrameLatency.
+    bool lowLatency;
+    
+    WindowConfig(const std::string& title = "ENGAIN Window",
+                 int width = 800,
+                 int height = 600,
+                 bool resizable = true)
+        : title(title), width(width), height(height), resizable(resizable),
+          mode(WindowMode::WINDOWED), fullscreen(FullscreenMode::WINDOWED),
+          vsync(VSyncMode::ON), batching(true), scaleQuality("nearest"),
+          dirtyRects(false), lowLatency(false) {}
+};
+
 class Window {
 public:
     Window(const std::string& title = "ENGAIN Window",
            int width = 800,
            int height = 600,
-           bool resizable = true);
+           bool resizable = true,
+           WindowMode mode = WindowMode::WINDOWED);
+    explicit Window(const WindowConfig& config);
     
     ~Window();
     
     bool initialize();
+    // Pump the EventDispatcher, which also updates the window state. In
+    // low-latency mode this first waits for the predicted frame start.
     void handleEvents();
     void clear(const Color& color = Color(0, 0, 0));
     void present();
     void close();
     
+    // With dirty rects on, record what a draw call touched this frame, in
+    // output pixels. Pixels drawn outside these rectangles may not show.
+    void markDirty(const SDL_Rect& rect);
+    void markAllDirty();
+    bool isTrackingDirtyRects() const { return config.dirtyRects; }
+    
+    // Write the current frame to a BMP file. For a windowed renderer call
+    // this before present(), the back buffer is undefined afterwards.
+    bool saveFrame(const std::string& path);
+    
+    // Asynchronous capture of presented frames, see FrameCapture
+    bool startCapture(const FrameCaptureConfig& config);
+    void stopCapture();
+    // Save the next presented frame as a PNG without stalling it
+    void takeScreenshot(const std::string& path = "");
+    FrameCapture* getCapture() const { return capture.get(); }
+    
+    // Input-to-present latency statistics and the low-latency pacing
+    const FrameLatency& getLatency() const { return latency; }
+    
     // Getters
     int getWidth() const { return width; }
     int getHeight() const { return height; }
     bool isRunning() const { return running; }
     bool isFocused() const { return focused; }
+    bool isHeadless() const { return config.mode == WindowMode::HEADLESS; }
     SDL_Renderer* getRenderer() const { return renderer; }
     SDL_Window* getSDLWindow() const { return window; }
+    // Frame the headless renderer draws into, null for a windowed renderer
+    SDL_Surface* getSurface() const { return surface; }
+    const WindowConfig& getConfig() const { return config; }
+    // Render driver actually in use, empty before initialize()
+    const std::string& getRendererName() const { return rendererName; }
+    
+    // Names of the render drivers this SDL build offers
+    static std::vector<std::string> getRenderDrivers();
     
     // Setters
     void setTitle(const std::string& title);
     
 private:
+    bool createRenderer();
+    void handleEvent(const SDL_Event& event);
+    void applyVSync();
+    void setupLatency();
+    void resetDirtyRects();
+    void presentDirtyRects();
+    
+    WindowConfig config;
     std::string title;
     int width;
     int height;
-    bool resizable;
+    std::string rendererName;
     
     bool running;
     bool focused;
@@ -51,6 +147,22 @@ private:
     
     SDL_Window* window;
     SDL_Renderer* renderer;
+    SDL_Surface* surface;
+    std::vector<EventListenerId> eventListeners;
+    std::unique_ptr<FrameCapture> capture;
+    FrameLatency latency;
+    
+    // Dirty-rect presentation: what was drawn this frame and the last one,
+    // and the union of both that present() updates
+    DirtyRegion drawn;
+    DirtyRegion drawnLast;
+    DirtyRegion presented;
+    Color clearColor;
+    bool backgroundValid;
+    bool frameCleared;
+    unsigned long long partialFrames;
+    unsigned long long fullFrames;
+    double presentedCoverage;
 };
 
 } // namespace ENGAIN
@@ -1,19 +1,34 @@
 #include "../ENGAIN/core/Window.h"
 #include "../ENGAIN/core/Texture.h"
+#include "../ENGAIN/core/AssetCache.h"
+#include "../ENGAIN/core/Profiler.h"
+#include "../ENGAIN/core/SamplingProfiler.h"
 #include <SDL2/SDL.h>
+#include <string>
 
 using namespace ENGAIN;
 
 int main(int argc, char* argv[]) {
+    Profiler::getInstance().initialize();
+    SamplingProfiler::getInstance().initialize();
+    
+    WindowConfig windowConfig("ENGAIN - Kitty Sprite", 1200, 800, true);
+    for (int i = 1; i < argc; i++) {
+        // Only the sprite changes, so redraw and present just that
+        if (std::string(argv[i]) == "--dirty-rects") {
+            windowConfig.dirtyRects = true;
+        }
+    }
+    
     // Create window
-    Window window("ENGAIN - Kitty Sprite", 1200, 800, true);
+    Window window(windowConfig);
     if (!window.initialize()) {
         return -1;
     }
     
     // Load kitty sprite
-    Texture kittySprite;
-    if (!kittySprite.loadFromFile("assets/kitty.png", window.getRenderer())) {
+    std::shared_ptr<Texture> kittySprite = AssetCache::getInstance().getTexture("assets/kitty.png", window.getRenderer());
+    if (!kittySprite) {
         return -1;
     }
     
@@ -21,6 +36,8 @@ int main(int argc, char* argv[]) {
     
     // Main loop
     while (window.isRunning()) {
+        ENGAIN_PROFILE_SCOPE("Frame");
+        
         // Handle events
         window.handleEvents();
         
@@ -42,12 +59,16 @@ int main(int argc, char* argv[]) {
             spriteSize
         };
         
-        SDL_RenderCopyEx(renderer, kittySprite.getSDLTexture(), nullptr, &dstRect, 
+        SDL_RenderCopyEx(renderer, kittySprite->getSDLTexture(), nullptr, &dstRect, 
                         0, nullptr, SDL_FLIP_NONE);
+        window.markDirty(dstRect);
         
         // Present
         window.present();
     }
     
+    AssetCache::getInstance().logReport();
+    SamplingProfiler::getInstance().shutdown();
+    Profiler::getInstance().shutdown();
     return 0;
 }
@@ -2,14 +2,21 @@
 #include "../ENGAIN/core/TimeManager.h"
 #include "../ENGAIN/core/Window.h"
 #include "../ENGAIN/core/Texture.h"
+#include "../ENGAIN/core/AssetCache.h"
 #include "../ENGAIN/core/Input.h"
 #include "../ENGAIN/core/Math.h"
 #include "../ENGAIN/core/Font.h"
+#include "../ENGAIN/core/RenderLayer.h"
+#include "../ENGAIN/core/Profiler.h"
+#include "../ENGAIN/core/PerfCounters.h"
+#include "../ENGAIN/core/SamplingProfiler.h"
+#include "../ENGAIN/core/FlightRecorder.h"
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_image.h>
 #include <vector>
 #include <cmath>
 #include <sstream>
+#include <iomanip>
 
 using namespace ENGAIN;
 
@@ -17,6 +24,7 @@ using namespace ENGAIN;
 class Player {
 public:
     Vector2 position;
+    Vector2 previousPosition;
     Vector2 velocity;
     float width, height;
     bool onGround;
@@ -34,10 +42,10 @@ public:
     const float MAX_FALL_SPEED = 500.0f;
     
     Player(float x, float y, Texture* tex) 
-        : position(x, y), velocity(0, 0), width(48), height(48),
+        : position(x, y), previousPosition(x, y), velocity(0, 0), width(48), height(48),
           onGround(false), facingRight(true), texture(tex) {}
     
-    void handleInput(float deltaTime) {
+    void handleInput(float deltaTime, bool jumpRequested) {
         Input& input = Input::getInstance();
         
         // Horizontal movement with acceleration
@@ -73,7 +81,7 @@ public:
         }
         
         // Jump
-        if ((input.isKeyPressed(SDLK_SPACE) || input.isKeyPressed(SDLK_UP) || input.isKeyPressed(SDLK_w)) && onGround) {
+        if (jumpRequested && onGround) {
             velocity.y = JUMP_FORCE;
             onGround = false;
         }
@@ -97,19 +105,22 @@ public:
         return Rectangle(position.x, position.y, width, height);
     }
     
-    void render(SDL_Renderer* renderer) {
+    void render(SDL_Renderer* renderer, float alpha) {
+        // Blend between the last two simulation steps
+        Vector2 drawPosition = lerp(previousPosition, position, alpha);
+        
         if (texture && texture->getSDLTexture()) {
             SDL_RendererFlip flip = facingRight ? SDL_FLIP_NONE : SDL_FLIP_HORIZONTAL;
             texture->renderScaled(renderer, 
-                                static_cast<int>(position.x), 
-                                static_cast<int>(position.y),
+                                static_cast<int>(drawPosition.x), 
+                                static_cast<int>(drawPosition.y),
                                 static_cast<int>(width),
                                 static_cast<int>(height),
                                 flip);
         } else {
             // Draw colored rectangle if no texture
             SDL_SetRenderDrawColor(renderer, 255, 100, 100, 255);
-            SDL_Rect rect = {static_cast<int>(position.x), static_cast<int>(position.y), 
+            SDL_Rect rect = {static_cast<int>(drawPosition.x), static_cast<int>(drawPosition.y), 
                            static_cast<int>(width), static_cast<int>(height)};
             SDL_RenderFillRect(renderer, &rect);
         }
@@ -140,6 +151,9 @@ int main() {
     // Initialize logger
     Logger::getInstance().initialize();
     Logger::getInstance().info("=== Game2 Platformer Starting ===");
+    Profiler::getInstance().initialize();
+    SamplingProfiler::getInstance().initialize();
+    FlightRecorder::getInstance().initialize();
     
     // Create window
     Window window("Game2 - Platformer", 1024, 600, false);
@@ -161,8 +175,7 @@ int main() {
     }
     
     // Load player texture
-    Texture kittyTexture;
-    kittyTexture.loadFromFile("assets/kitty.png", window.getRenderer());
+    std::shared_ptr<Texture> kittyTexture = AssetCache::getInstance().getTexture("assets/kitty.png", window.getRenderer());
     
     // Load font
     Font gameFont;
@@ -172,9 +185,13 @@ int main() {
     
     // Create time manager
     TimeManager timeManager(60);
+    timeManager.setFixedTimestep(120.0f);
+    if (PerfCounters::initialize()) {
+        timeManager.enablePerfCounters();
+    }
     
     // Create player
-    Player player(50, 100, &kittyTexture);
+    Player player(50, 100, kittyTexture.get());
     
     // Create level platforms
     std::vector<Platform> platforms;
@@ -200,101 +217,148 @@ int main() {
     platforms.push_back(Platform(850, 480, 60, 15, Color(100, 100, 200)));
     platforms.push_back(Platform(950, 420, 60, 15, Color(100, 100, 200)));
     
+    // The platforms never move, so draw them once into a cached layer
+    LayerStack layers(window);
+    layers.addLayer("platforms", 0, [&platforms](SDL_Renderer* renderer) {
+        for (auto& platform : platforms) {
+            platform.render(renderer);
+        }
+    });
+    
     // Background color
     Color skyColor(100, 150, 230);
     
+    bool jumpRequested = false;
+    
     Logger::getInstance().info("Entering main loop");
     
     // Main game loop
     while (window.isRunning()) {
+        ENGAIN_PROFILE_SCOPE("Frame");
+        
         // Handle events
         window.handleEvents();
         
         // Update time
         timeManager.update();
-        float deltaTime = timeManager.getDeltaTime();
         
         // Update input
         Input::getInstance().update();
         
-        // Handle player input
-        player.handleInput(deltaTime);
-        
-        // Update player physics
-        player.update(deltaTime);
-        
-        // Collision detection - more robust
-        player.onGround = false;
-        Rectangle playerBounds = player.getBounds();
+        // Latch the jump press so it is not lost on frames that run no step
+        Input& input = Input::getInstance();
+        if (input.isKeyPressed(SDLK_SPACE) || input.isKeyPressed(SDLK_UP) || input.isKeyPressed(SDLK_w)) {
+            jumpRequested = true;
+        }
         
-        for (auto& platform : platforms) {
-            if (playerBounds.intersects(platform.bounds)) {
-                // Calculate overlap on each axis
-                float overlapLeft = (playerBounds.x + playerBounds.width) - platform.bounds.x;
-                float overlapRight = (platform.bounds.x + platform.bounds.width) - playerBounds.x;
-                float overlapTop = (playerBounds.y + playerBounds.height) - platform.bounds.y;
-                float overlapBottom = (platform.bounds.y + platform.bounds.height) - playerBounds.y;
-                
-                // Find minimum overlap
-                float minOverlapX = (overlapLeft < overlapRight) ? overlapLeft : -overlapRight;
-                float minOverlapY = (overlapTop < overlapBottom) ? overlapTop : -overlapBottom;
-                
-                // Resolve collision on axis with smallest overlap
-                if (std::abs(minOverlapX) < std::abs(minOverlapY)) {
-                    // Horizontal collision
-                    player.position.x -= minOverlapX;
-                    player.velocity.x = 0;
-                } else {
-                    // Vertical collision
-                    player.position.y -= minOverlapY;
-                    if (minOverlapY > 0 && player.velocity.y >= 0) {
-                        // Landing on top - only set onGround if falling or stationary
-                        player.velocity.y = 0;
-                        player.onGround = true;
+        // Run the simulation in fixed steps
+        while (timeManager.consumeFixedStep()) {
+            ENGAIN_PROFILE_SCOPE("Simulation step");
+            float deltaTime = timeManager.getFixedDeltaTime();
+            player.previousPosition = player.position;
+            
+            // Handle player input
+            player.handleInput(deltaTime, jumpRequested);
+            jumpRequested = false;
+            
+            // Update player physics
+            player.update(deltaTime);
+            
+            // Collision detection - more robust
+            ENGAIN_PROFILE_SCOPE("Collisions");
+            player.onGround = false;
+            Rectangle playerBounds = player.getBounds();
+            
+            for (auto& platform : platforms) {
+                if (playerBounds.intersects(platform.bounds)) {
+                    // Calculate overlap on each axis
+                    float overlapLeft = (playerBounds.x + playerBounds.width) - platform.bounds.x;
+                    float overlapRight = (platform.bounds.x + platform.bounds.width) - playerBounds.x;
+                    float overlapTop = (playerBounds.y + playerBounds.height) - platform.bounds.y;
+                    float overlapBottom = (platform.bounds.y + platform.bounds.height) - playerBounds.y;
+                    
+                    // Find minimum overlap
+                    float minOverlapX = (overlapLeft < overlapRight) ? overlapLeft : -overlapRight;
+                    float minOverlapY = (overlapTop < overlapBottom) ? overlapTop : -overlapBottom;
+                    
+                    // Resolve collision on axis with smallest overlap
+                    if (std::abs(minOverlapX) < std::abs(minOverlapY)) {
+                        // Horizontal collision
+                        player.position.x -= minOverlapX;
+                        player.velocity.x = 0;
                     } else {
-                        // Hit from below
-                        player.velocity.y = 0;
+                        // Vertical collision
+                        player.position.y -= minOverlapY;
+                        if (minOverlapY > 0 && player.velocity.y >= 0) {
+                            // Landing on top - only set onGround if falling or stationary
+                            player.velocity.y = 0;
+                            player.onGround = true;
+                        } else {
+                            // Hit from below
+                            player.velocity.y = 0;
+                        }
                     }
                 }
             }
-        }
-        
-        // Keep player in horizontal bounds
-        if (player.position.x < 0) {
-            player.position.x = 0;
-            player.velocity.x = 0;
-        }
-        if (player.position.x + player.width > window.getWidth()) {
-            player.position.x = window.getWidth() - player.width;
-            player.velocity.x = 0;
-        }
-        
-        // Reset if player falls off screen
-        if (player.position.y > window.getHeight()) {
-            player.position = Vector2(50, 100);
-            player.velocity = Vector2(0, 0);
-            Logger::getInstance().info("Player respawned");
+            
+            // Keep player in horizontal bounds
+            if (player.position.x < 0) {
+                player.position.x = 0;
+                player.velocity.x = 0;
+            }
+            if (player.position.x + player.width > window.getWidth()) {
+                player.position.x = window.getWidth() - player.width;
+                player.velocity.x = 0;
+            }
+            
+            // Reset if player falls off screen
+            if (player.position.y > window.getHeight()) {
+                player.position = Vector2(50, 100);
+                player.velocity = Vector2(0, 0);
+                player.previousPosition = player.position;
+                Logger::getInstance().info("Player respawned");
+            }
         }
         
         // Render
+        ENGAIN_PROFILE_SCOPE("Render");
         window.clear(skyColor);
         
         SDL_Renderer* renderer = window.getRenderer();
         
         // Draw platforms
-        for (auto& platform : platforms) {
-            platform.render(renderer);
-        }
+        layers.render();
         
         // Draw player
-        player.render(renderer);
+        player.render(renderer, timeManager.getInterpolationAlpha());
         
         // Draw UI
+        ENGAIN_PROFILE_SCOPE("HUD");
         std::ostringstream fpsText;
-        fpsText << "FPS: " << static_cast<int>(timeManager.getFPS());
+        fpsText << "FPS: " << static_cast<int>(timeManager.getFPS())
+                << "  Jitter: " << std::fixed << std::setprecision(2)
+                << timeManager.getFrameTimeJitter() * 1000.0f << " ms";
         SDL_Color whiteColor = {255, 255, 255, 255};
         gameFont.drawText(renderer, fpsText.str(), 10, 10, whiteColor);
         
+        const FrameStats::Summary& frameSummary = timeManager.getFrameStats().getSummary();
+        std::ostringstream statsText;
+        statsText << std::fixed << std::setprecision(1)
+                  << "p99: " << frameSummary.p99 * 1000.0f << " ms  max: " << frameSummary.max * 1000.0f
+                  << " ms  1% low: " << static_cast<int>(frameSummary.low1)
+                  << "  over budget: " << frameSummary.overBudget;
+        gameFont.drawText(renderer, statsText.str(), 10, 40, whiteColor);
+        
+        if (timeManager.hasPerfCounters()) {
+            const PerfCounterValues& counters = timeManager.getAverageFrameCounters();
+            std::ostringstream perfText;
+            perfText << std::fixed << std::setprecision(2) << "IPC: " << counters.getIPC()
+                     << "  L1d misses: " << counters[PerfEvent::L1D_MISSES]
+                     << "  LLC misses: " << counters[PerfEvent::LLC_MISSES]
+                     << "  branch misses: " << counters[PerfEvent::BRANCH_MISSES];
+            gameFont.drawText(renderer, perfText.str(), 10, 70, whiteColor);
+        }
+        
         gameFont.drawText(renderer, "Controls: A/D or Arrow Keys to move, SPACE/W/UP to jump", 
                          10, window.getHeight() - 30, whiteColor);
         
@@ -303,6 +367,13 @@ int main() {
     
     // Cleanup
     Logger::getInstance().info("=== Shutting down ===");
+    if (timeManager.hasPerfCounters()) {
+        PerfCounters::forCurrentThread()->logScopeReport();
+    }
+    AssetCache::getInstance().logReport();
+    FlightRecorder::getInstance().shutdown();
+    SamplingProfiler::getInstance().shutdown();
+    Profiler::getInstance().shutdown();
     TTF_Quit();
     IMG_Quit();
     
@@ -4,12 +4,20 @@
 #include "../ENGAIN/core/Input.h"
 #include "../ENGAIN/core/Math.h"
 #include "../ENGAIN/core/Font.h"
+#include "../ENGAIN/core/AssetCache.h"
+#include "../ENGAIN/core/Profiler.h"
+#include "../ENGAIN/core/PerfCounters.h"
+#include "../ENGAIN/core/SamplingProfiler.h"
+#include "../ENGAIN/core/FlightRecorder.h"
 #include <SDL2/SDL.h>
 #include <vector>
 #include <cmath>
 #include <random>
 #include <sstream>
 #include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include <string>
 
 using namespace ENGAIN;
 
@@ -31,21 +39,43 @@ public:
     float rotationSpeed;
     bool active;
     
-    GameObject() : position(0, 0), velocity(0, 0), rotation(0), rotationSpeed(0), active(true) {}
+    // State at the previous simulation step, for render interpolation
+    Vector2 previousPosition;
+    float previousRotation;
+    
+    GameObject() : position(0, 0), velocity(0, 0), rotation(0), rotationSpeed(0), active(true),
+                   previousPosition(0, 0), previousRotation(0) {}
+    
+    void savePreviousState() {
+        previousPosition = position;
+        previousRotation = rotation;
+    }
     
     virtual void update(float dt, int screenWidth, int screenHeight) {
         position.x += velocity.x * dt;
         position.y += velocity.y * dt;
         rotation += rotationSpeed * dt;
         
-        // Wrap around screen
-        if (position.x < 0) position.x += screenWidth;
-        if (position.x > screenWidth) position.x -= screenWidth;
-        if (position.y < 0) position.y += screenHeight;
-        if (position.y > screenHeight) position.y -= screenHeight;
+        // Wrap around screen, moving the previous position along so
+        // interpolation does not sweep across the screen
+        Vector2 wrap(0, 0);
+        if (position.x < 0) wrap.x = screenWidth;
+        if (position.x > screenWidth) wrap.x = -screenWidth;
+        if (position.y < 0) wrap.y = screenHeight;
+        if (position.y > screenHeight) wrap.y = -screenHeight;
+        position += wrap;
+        previousPosition += wrap;
+    }
+    
+    Vector2 getRenderPosition(float alpha) const {
+        return lerp(previousPosition, position, alpha);
+    }
+    
+    float getRenderRotation(float alpha) const {
+        return lerp(previousRotation, rotation, alpha);
     }
     
-    virtual void render(SDL_Renderer* renderer) = 0;
+    virtual void render(SDL_Renderer* renderer, float alpha) = 0;
     virtual float getRadius() const = 0;
     virtual ~GameObject() {}
 };
@@ -59,11 +89,13 @@ public:
     float drag;
     int lives;
     bool invulnerable;
-    float invulnerableTime;
+    TimerWheel& timers;
+    TimerHandle invulnerableTimer;
     
-    Ship(float x, float y) : size(15.0f), thrusting(false), thrustPower(300.0f), 
-                             drag(0.99f), lives(3), invulnerable(true), invulnerableTime(3.0f) {
+    Ship(float x, float y, TimerWheel& timers) : size(15.0f), thrusting(false), thrustPower(300.0f), 
+                             drag(0.99f), lives(3), invulnerable(false), timers(timers) {
         position = Vector2(x, y);
+        makeInvulnerable();
     }
     
     void update(float dt, int screenWidth, int screenHeight) override {
@@ -90,32 +122,27 @@ public:
         velocity.x *= drag;
         velocity.y *= drag;
         
-        // Update invulnerability
-        if (invulnerable) {
-            invulnerableTime -= dt;
-            if (invulnerableTime <= 0) {
-                invulnerable = false;
-            }
-        }
-        
         GameObject::update(dt, screenWidth, screenHeight);
     }
     
-    void render(SDL_Renderer* renderer) override {
+    void render(SDL_Renderer* renderer, float alpha) override {
         if (invulnerable) {
-            int flash = (int)(invulnerableTime * 10) % 2;
+            int flash = (int)(timers.getRemaining(invulnerableTimer) * 10) % 2;
             if (flash == 0) return; // Blink when invulnerable
         }
         
-        float rad = rotation * M_PI / 180.0f;
+        Vector2 drawPosition = getRenderPosition(alpha);
+        float drawRotation = getRenderRotation(alpha);
+        
+        float rad = drawRotation * M_PI / 180.0f;
         
         // Ship vertices (triangle)
-        Vector2 front(position.x + cos(rad) * size, 
-                      position.y + sin(rad) * size);
-        Vector2 left(position.x + cos(rad + 2.5f) * size * 0.6f, 
-                     position.y + sin(rad + 2.5f) * size * 0.6f);
-        Vector2 right(position.x + cos(rad - 2.5f) * size * 0.6f, 
-                      position.y + sin(rad - 2.5f) * size * 0.6f);
+        Vector2 front(drawPosition.x + cos(rad) * size, 
+                      drawPosition.y + sin(rad) * size);
+        Vector2 left(drawPosition.x + cos(rad + 2.5f) * size * 0.6f, 
+                     drawPosition.y + sin(rad + 2.5f) * size * 0.6f);
+        Vector2 right(drawPosition.x + cos(rad - 2.5f) * size * 0.6f, 
+                      drawPosition.y + sin(rad - 2.5f) * size * 0.6f);
         
         SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
         SDL_RenderDrawLine(renderer, front.x, front.y, left.x, left.y);
@@ -124,8 +151,8 @@ public:
         
         // Thrust flame
         if (thrusting) {
-            Vector2 back(position.x - cos(rad) * size * 0.8f, 
-                        position.y - sin(rad) * size * 0.8f);
+            Vector2 back(drawPosition.x - cos(rad) * size * 0.8f, 
+                        drawPosition.y - sin(rad) * size * 0.8f);
             SDL_SetRenderDrawColor(renderer, 255, 150, 0, 255);
             SDL_RenderDrawLine(renderer, left.x, left.y, back.x, back.y);
             SDL_RenderDrawLine(renderer, right.x, right.y, back.x, back.y);
@@ -138,8 +165,15 @@ public:
         position = Vector2(x, y);
         velocity = Vector2(0, 0);
         rotation = 0;
+        makeInvulnerable();
+        savePreviousState();
+    }
+    
+    // Invulnerable for a few seconds after spawning
+    void makeInvulnerable() {
+        timers.cancel(invulnerableTimer);
         invulnerable = true;
-        invulnerableTime = 3.0f;
+        invulnerableTimer = timers.schedule(3.0f, [this]() { invulnerable = false; }, this);
     }
 };
 
@@ -147,34 +181,33 @@ public:
 class Bullet : public GameObject {
 public:
     float size;
-    float lifetime;
     float maxLifetime;
+    TimerHandle lifetimeTimer;
     
-    Bullet() : size(2.0f), lifetime(0), maxLifetime(2.0f) {
+    Bullet() : size(2.0f), maxLifetime(2.0f) {
         active = false;
     }
     
-    void fire(Vector2 pos, float rot, Vector2 shipVel) {
+    void fire(Vector2 pos, float rot, Vector2 shipVel, TimerWheel& timers) {
         position = pos;
         rotation = rot;
         float rad = rot * M_PI / 180.0f;
         velocity.x = cos(rad) * 500.0f + shipVel.x;
         velocity.y = sin(rad) * 500.0f + shipVel.y;
-        lifetime = 0;
         active = true;
+        savePreviousState();
+        
+        // Expire after maxLifetime; a bullet that hit something may be
+        // fired again before its old timer runs out
+        timers.cancel(lifetimeTimer);
+        lifetimeTimer = timers.schedule(maxLifetime, [this]() { active = false; }, this);
     }
     
-    void update(float dt, int screenWidth, int screenHeight) override {
-        lifetime += dt;
-        if (lifetime > maxLifetime) {
-            active = false;
-        }
-        GameObject::update(dt, screenWidth, screenHeight);
-    }
-    
-    void render(SDL_Renderer* renderer) override {
+    void render(SDL_Renderer* renderer, float alpha) override {
+        Vector2 drawPosition = getRenderPosition(alpha);
+        
         SDL_SetRenderDrawColor(renderer, 255, 255, 0, 255);
-        SDL_Rect rect = {(int)(position.x - size), (int)(position.y - size), 
+        SDL_Rect rect = {(int)(drawPosition.x - size), (int)(drawPosition.y - size), 
                         (int)(size * 2), (int)(size * 2)};
         SDL_RenderFillRect(renderer, &rect);
     }
@@ -236,26 +269,30 @@ public:
         }
         
         active = true;
+        savePreviousState();
     }
     
-    void render(SDL_Renderer* renderer) override {
+    void render(SDL_Renderer* renderer, float alpha) override {
+        Vector2 drawPosition = getRenderPosition(alpha);
+        float drawRotation = getRenderRotation(alpha);
+        
         SDL_SetRenderDrawColor(renderer, 200, 200, 200, 255);
         
         for (size_t i = 0; i < shape.size(); i++) {
             size_t next = (i + 1) % shape.size();
             
-            float rad = rotation * M_PI / 180.0f;
+            float rad = drawRotation * M_PI / 180.0f;
             float cos_r = cos(rad);
             float sin_r = sin(rad);
             
             // Rotate and translate
             Vector2 p1(
-                position.x + shape[i].x * cos_r - shape[i].y * sin_r,
-                position.y + shape[i].x * sin_r + shape[i].y * cos_r
+                drawPosition.x + shape[i].x * cos_r - shape[i].y * sin_r,
+                drawPosition.y + shape[i].x * sin_r + shape[i].y * cos_r
             );
             Vector2 p2(
-                position.x + shape[next].x * cos_r - shape[next].y * sin_r,
-                position.y + shape[next].x * sin_r + shape[next].y * cos_r
+                drawPosition.x + shape[next].x * cos_r - shape[next].y * sin_r,
+                drawPosition.y + shape[next].x * sin_r + shape[next].y * cos_r
             );
             
             SDL_RenderDrawLine(renderer, p1.x, p1.y, p2.x, p2.y);
@@ -274,20 +311,42 @@ bool checkCollision(GameObject* a, GameObject* b) {
 }
 
 int main(int argc, char* argv[]) {
+    // --soak [seconds] plays unattended on a virtual clock as fast as possible
+    // --low-latency samples input just before the next vblank
+    bool soakMode = false;
+    float soakSeconds = 600.0f;
+    bool lowLatency = false;
+    for (int i = 1; i < argc; i++) {
+        if (std::string(argv[i]) == "--soak") {
+            soakMode = true;
+            if (i + 1 < argc && std::atof(argv[i + 1]) > 0.0f) {
+                soakSeconds = static_cast<float>(std::atof(argv[++i]));
+            }
+        } else if (std::string(argv[i]) == "--low-latency") {
+            lowLatency = true;
+        }
+    }
+    
     Logger::getInstance().initialize();
     Logger::getInstance().info("=== Game5 - Asteroids Starting ===");
+    Profiler::getInstance().initialize();
+    SamplingProfiler::getInstance().initialize();
+    FlightRecorder::getInstance().initialize();
     
     // Create fullscreen window
-    Window window("Game5 - Asteroids | ESC to Exit", 1920, 1080, false);
+    WindowConfig windowConfig("Game5 - Asteroids | ESC to Exit", 1920, 1080, false);
+    windowConfig.fullscreen = FullscreenMode::DESKTOP;
+    windowConfig.lowLatency = lowLatency;
+    // Soak runs should not wait for the display
+    if (soakMode) {
+        windowConfig.vsync = VSyncMode::OFF;
+    }
+    Window window(windowConfig);
     if (!window.initialize()) {
         Logger::getInstance().error("Failed to initialize window");
         return -1;
     }
     
-    // Set fullscreen
-    SDL_SetWindowFullscreen(window.getSDLWindow(), SDL_WINDOW_FULLSCREEN_DESKTOP);
-    SDL_Delay(16);
-    
     // Initialize text renderer
     TextRenderer& textRenderer = TextRenderer::getInstance();
     textRenderer.initialize();
@@ -295,12 +354,26 @@ int main(int argc, char* argv[]) {
     textRenderer.loadFont("large", "/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf", 48);
     
     TimeManager timeManager(60);
+    timeManager.setFixedTimestep(60.0f);
+    if (PerfCounters::initialize()) {
+        timeManager.enablePerfCounters();
+    }
+    
+    if (soakMode) {
+        // Same seed and same deltas every run
+        timeManager.useVirtualClock(1.0f / 60.0f);
+        gen.seed(12345);
+        srand(12345);
+        Logger::getInstance().info("Soak test: " + std::to_string(soakSeconds) + " simulated seconds");
+    }
+    auto wallStart = std::chrono::steady_clock::now();
     
     int screenWidth = window.getWidth();
     int screenHeight = window.getHeight();
     
     // Game objects
-    Ship ship(screenWidth / 2, screenHeight / 2);
+    TimerWheel& timers = timeManager.getTimers();
+    Ship ship(screenWidth / 2, screenHeight / 2, timers);
     std::vector<Bullet> bullets(20);
     std::vector<Asteroid> asteroids(50);
     
@@ -308,8 +381,7 @@ int main(int argc, char* argv[]) {
     int score = 0;
     int level = 1;
     bool gameOver = false;
-    float respawnTimer = 0;
-    float shootCooldown = 0;
+    bool canShoot = true;
     const float SHOOT_DELAY = 0.25f;
     
     // Spawn initial asteroids
@@ -339,6 +411,11 @@ int main(int argc, char* argv[]) {
     
     // Main game loop
     while (window.isRunning()) {
+        ENGAIN_PROFILE_SCOPE("Frame");
+        if (soakMode && timeManager.getTotalTime() >= soakSeconds) {
+            break;
+        }
+        
         window.handleEvents();
         Input::getInstance().update();
         
@@ -347,157 +424,182 @@ int main(int argc, char* argv[]) {
             break;
         }
         
-        timeManager.update();
-        float dt = timeManager.getDeltaTime();
-        if (dt > 0.1f) dt = 0.1f;
+        // F12 saves a screenshot
+        if (Input::getInstance().isKeyPressed(SDLK_F12)) {
+            window.takeScreenshot();
+        }
         
-        shootCooldown -= dt;
+        timeManager.update();
         
-        if (!gameOver) {
-            // Update ship
-            ship.update(dt, screenWidth, screenHeight);
+        // Game over - restart with R
+        if (gameOver && (soakMode || Input::getInstance().isKeyPressed(SDLK_r))) {
+            ship.lives = 3;
+            ship.reset(screenWidth / 2, screenHeight / 2);
+            score = 0;
+            level = 1;
+            gameOver = false;
             
-            // Shoot
-            if ((Input::getInstance().isKeyDown(SDLK_SPACE) || 
-                 Input::getInstance().isKeyDown(SDLK_RETURN)) && shootCooldown <= 0) {
-                for (auto& bullet : bullets) {
-                    if (!bullet.active) {
-                        float rad = ship.rotation * M_PI / 180.0f;
-                        Vector2 gunPos(ship.position.x + cos(rad) * ship.size,
-                                      ship.position.y + sin(rad) * ship.size);
-                        bullet.fire(gunPos, ship.rotation, ship.velocity);
-                        shootCooldown = SHOOT_DELAY;
-                        break;
-                    }
-                }
-            }
-            
-            // Update bullets
+            // Clear all
             for (auto& bullet : bullets) {
-                if (bullet.active) {
-                    bullet.update(dt, screenWidth, screenHeight);
-                }
+                bullet.active = false;
+                timers.cancelOwner(&bullet);
             }
+            canShoot = true;
+            for (auto& asteroid : asteroids) asteroid.active = false;
             
-            // Update asteroids
-            for (auto& asteroid : asteroids) {
-                if (asteroid.active) {
-                    asteroid.update(dt, screenWidth, screenHeight);
-                }
-            }
+            spawnLevel(3 + level);
+        }
+        
+        // Run the simulation in fixed steps
+        while (timeManager.consumeFixedStep()) {
+            ENGAIN_PERF_SCOPE("Simulation step");
+            float dt = timeManager.getFixedDeltaTime();
             
-            // Check bullet-asteroid collisions
-            for (auto& bullet : bullets) {
-                if (!bullet.active) continue;
+            ship.savePreviousState();
+            for (auto& bullet : bullets) bullet.savePreviousState();
+            for (auto& asteroid : asteroids) asteroid.savePreviousState();
+            
+            if (!gameOver) {
+                // Update ship
+                ship.update(dt, screenWidth, screenHeight);
+                
+                // Shoot
+                if ((soakMode || Input::getInstance().isKeyDown(SDLK_SPACE) || 
+                     Input::getInstance().isKeyDown(SDLK_RETURN)) && canShoot) {
+                    for (auto& bullet : bullets) {
+                        if (!bullet.active) {
+                            float rad = ship.rotation * M_PI / 180.0f;
+                            Vector2 gunPos(ship.position.x + cos(rad) * ship.size,
+                                          ship.position.y + sin(rad) * ship.size);
+                            bullet.fire(gunPos, ship.rotation, ship.velocity, timers);
+                            canShoot = false;
+                            timers.schedule(SHOOT_DELAY, [&canShoot]() { canShoot = true; });
+                            break;
+                        }
+                    }
+                }
                 
+                // Update bullets
+                for (auto& bullet : bullets) {
+                    if (bullet.active) {
+                        bullet.update(dt, screenWidth, screenHeight);
+                    }
+                }
+                
+                // Update asteroids
                 for (auto& asteroid : asteroids) {
-                    if (!asteroid.active) continue;
+                    if (asteroid.active) {
+                        asteroid.update(dt, screenWidth, screenHeight);
+                    }
+                }
+                
+                // Check bullet-asteroid collisions
+                ENGAIN_PERF_SCOPE("Collisions");
+                for (auto& bullet : bullets) {
+                    if (!bullet.active) continue;
                     
-                    if (checkCollision(&bullet, &asteroid)) {
-                        bullet.active = false;
-                        asteroid.active = false;
-                        score += asteroid.points;
+                    for (auto& asteroid : asteroids) {
+                        if (!asteroid.active) continue;
                         
-                        // Split asteroid if not small
-                        if (asteroid.asteroidSize == Asteroid::LARGE) {
-                            for (int i = 0; i < 2; i++) {
-                                for (auto& newAst : asteroids) {
-                                    if (!newAst.active) {
-                                        float angle = randomFloat(0, 2 * M_PI);
-                                        float speed = randomFloat(60, 120);
-                                        Vector2 vel(cos(angle) * speed, sin(angle) * speed);
-                                        newAst.spawn(asteroid.position, Asteroid::MEDIUM, vel);
-                                        break;
+                        if (checkCollision(&bullet, &asteroid)) {
+                            bullet.active = false;
+                            asteroid.active = false;
+                            score += asteroid.points;
+                            
+                            // Split asteroid if not small
+                            if (asteroid.asteroidSize == Asteroid::LARGE) {
+                                for (int i = 0; i < 2; i++) {
+                                    for (auto& newAst : asteroids) {
+                                        if (!newAst.active) {
+                                            float angle = randomFloat(0, 2 * M_PI);
+                                            float speed = randomFloat(60, 120);
+                                            Vector2 vel(cos(angle) * speed, sin(angle) * speed);
+                                            newAst.spawn(asteroid.position, Asteroid::MEDIUM, vel);
+                                            break;
+                                        }
                                     }
                                 }
-                            }
-                        } else if (asteroid.asteroidSize == Asteroid::MEDIUM) {
-                            for (int i = 0; i < 2; i++) {
-                                for (auto& newAst : asteroids) {
-                                    if (!newAst.active) {
-                                        float angle = randomFloat(0, 2 * M_PI);
-                                        float speed = randomFloat(80, 150);
-                                        Vector2 vel(cos(angle) * speed, sin(angle) * speed);
-                                        newAst.spawn(asteroid.position, Asteroid::SMALL, vel);
-                                        break;
+                            } else if (asteroid.asteroidSize == Asteroid::MEDIUM) {
+                                for (int i = 0; i < 2; i++) {
+                                    for (auto& newAst : asteroids) {
+                                        if (!newAst.active) {
+                                            float angle = randomFloat(0, 2 * M_PI);
+                                            float speed = randomFloat(80, 150);
+                                            Vector2 vel(cos(angle) * speed, sin(angle) * speed);
+                                            newAst.spawn(asteroid.position, Asteroid::SMALL, vel);
+                                            break;
+                                        }
                                     }
                                 }
                             }
+                            break;
                         }
-                        break;
                     }
                 }
-            }
-            
-            // Check ship-asteroid collisions
-            if (!ship.invulnerable) {
-                for (auto& asteroid : asteroids) {
-                    if (asteroid.active && checkCollision(&ship, &asteroid)) {
-                        ship.lives--;
-                        if (ship.lives > 0) {
-                            ship.reset(screenWidth / 2, screenHeight / 2);
-                        } else {
-                            gameOver = true;
+                
+                // Check ship-asteroid collisions
+                if (!ship.invulnerable) {
+                    for (auto& asteroid : asteroids) {
+                        if (asteroid.active && checkCollision(&ship, &asteroid)) {
+                            ship.lives--;
+                            if (ship.lives > 0) {
+                                ship.reset(screenWidth / 2, screenHeight / 2);
+                            } else {
+                                gameOver = true;
+                            }
+                            break;
                         }
-                        break;
                     }
                 }
-            }
-            
-            // Check if level complete
-            bool allClear = true;
-            for (const auto& asteroid : asteroids) {
-                if (asteroid.active) {
-                    allClear = false;
-                    break;
-                }
-            }
-            
-            if (allClear) {
-                level++;
-                spawnLevel(3 + level);
-            }
-        } else {
-            // Game over - restart with R
-            if (Input::getInstance().isKeyPressed(SDLK_r)) {
-                ship.lives = 3;
-                ship.reset(screenWidth / 2, screenHeight / 2);
-                score = 0;
-                level = 1;
-                gameOver = false;
                 
-                // Clear all
-                for (auto& bullet : bullets) bullet.active = false;
-                for (auto& asteroid : asteroids) asteroid.active = false;
+                // Check if level complete
+                bool allClear = true;
+                for (const auto& asteroid : asteroids) {
+                    if (asteroid.active) {
+                        allClear = false;
+                        break;
+                    }
+                }
                 
-                spawnLevel(3 + level);
+                if (allClear) {
+                    level++;
+                    spawnLevel(3 + level);
+                }
             }
         }
         
+        // Soak runs only draw once per simulated second
+        if (soakMode && timeManager.getFrameCount() % 60 != 0) {
+            continue;
+        }
+        
         // Render
+        ENGAIN_PROFILE_SCOPE("Render");
+        float alpha = timeManager.getInterpolationAlpha();
         window.clear(Color(0, 0, 0));
         SDL_Renderer* renderer = window.getRenderer();
         
         // Draw asteroids
         for (auto& asteroid : asteroids) {
             if (asteroid.active) {
-                asteroid.render(renderer);
+                asteroid.render(renderer, alpha);
             }
         }
         
         // Draw bullets
         for (auto& bullet : bullets) {
             if (bullet.active) {
-                bullet.render(renderer);
+                bullet.render(renderer, alpha);
             }
         }
         
         // Draw ship
         if (!gameOver) {
-            ship.render(renderer);
+            ship.render(renderer, alpha);
         }
         
         // Draw UI
+        ENGAIN_PROFILE_SCOPE("HUD");
         std::ostringstream scoreText;
         scoreText << "SCORE: " << score;
         textRenderer.drawText(renderer, scoreText.str(), 20, 20, "default", 
@@ -518,6 +620,17 @@ int main(int argc, char* argv[]) {
             SDL_RenderDrawLine(renderer, x + 5, y + 8, x + 10, y);
         }
         
+        if (timeManager.hasPerfCounters()) {
+            const PerfCounterValues& counters = timeManager.getAverageFrameCounters();
+            std::ostringstream perfText;
+            perfText << std::fixed << std::setprecision(2) << "IPC: " << counters.getIPC()
+                     << "  L1d misses: " << counters[PerfEvent::L1D_MISSES]
+                     << "  LLC misses: " << counters[PerfEvent::LLC_MISSES]
+                     << "  branch misses: " << counters[PerfEvent::BRANCH_MISSES];
+            textRenderer.drawText(renderer, perfText.str(), 20, screenHeight - 40, "default",
+                                 SDL_Color{255, 255, 255, 255});
+        }
+        
         if (gameOver) {
             std::string gameOverText = "GAME OVER";
             textRenderer.drawText(renderer, gameOverText, screenWidth / 2 - 150, screenHeight / 2 - 50, 
@@ -532,7 +645,24 @@ int main(int argc, char* argv[]) {
     }
     
     Logger::getInstance().info("Game ended");
+    if (timeManager.hasPerfCounters()) {
+        PerfCounters::forCurrentThread()->logScopeReport();
+    }
+    AssetCache::getInstance().logReport();
+    FlightRecorder::getInstance().shutdown();
+    SamplingProfiler::getInstance().shutdown();
+    Profiler::getInstance().shutdown();
     Logger::getInstance().info("Final score: " + std::to_string(score));
     
+    if (soakMode) {
+        float wallSeconds = std::chrono::duration<float>(std::chrono::steady_clock::now() - wallStart).count();
+        std::ostringstream report;
+        report << std::fixed << std::setprecision(2)
+               << "Soak finished: " << timeManager.getFrameCount() << " frames, "
+               << timeManager.getTotalTime() << " s simulated in " << wallSeconds << " s ("
+               << timeManager.getTotalTime() / wallSeconds << "x), reached level " << level;
+        Logger::getInstance().info(report.str());
+    }
+    
     return 0;
 }
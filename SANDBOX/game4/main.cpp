@@ -2,15 +2,28 @@
 #include "../ENGAIN/core/TimeManager.h"
 #include "../ENGAIN/core/Window.h"
 #include "../ENGAIN/core/Texture.h"
+#include "../ENGAIN/core/TextureAtlas.h"
+#include "../ENGAIN/core/AssetCache.h"
+#include "../ENGAIN/core/AssetLoader.h"
+#include "../ENGAIN/core/SpriteBatch.h"
 #include "../ENGAIN/core/Input.h"
 #include "../ENGAIN/core/Math.h"
 #include "../ENGAIN/core/Font.h"
+#include "../ENGAIN/core/RenderLayer.h"
+#include "../ENGAIN/core/Profiler.h"
+#include "../ENGAIN/core/PerfCounters.h"
+#include "../ENGAIN/core/SamplingProfiler.h"
+#include "../ENGAIN/core/FlightRecorder.h"
 #include <SDL2/SDL.h>
 #include <vector>
+#include <deque>
 #include <cmath>
 #include <random>
 #include <sstream>
 #include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include <string>
 
 using namespace ENGAIN;
 
@@ -32,21 +45,43 @@ public:
     float rotationSpeed;
     bool active;
     
-    GameObject() : position(0, 0), velocity(0, 0), rotation(0), rotationSpeed(0), active(true) {}
+    // State at the previous simulation step, for render interpolation
+    Vector2 previousPosition;
+    float previousRotation;
+    
+    GameObject() : position(0, 0), velocity(0, 0), rotation(0), rotationSpeed(0), active(true),
+                   previousPosition(0, 0), previousRotation(0) {}
+    
+    void savePreviousState() {
+        previousPosition = position;
+        previousRotation = rotation;
+    }
     
     virtual void update(float dt, int screenWidth, int screenHeight) {
         position.x += velocity.x * dt;
         position.y += velocity.y * dt;
         rotation += rotationSpeed * dt;
         
-        // Wrap around screen
-        if (position.x < 0) position.x += screenWidth;
-        if (position.x > screenWidth) position.x -= screenWidth;
-        if (position.y < 0) position.y += screenHeight;
-        if (position.y > screenHeight) position.y -= screenHeight;
+        // Wrap around screen, moving the previous position along so
+        // interpolation does not sweep across the screen
+        Vector2 wrap(0, 0);
+        if (position.x < 0) wrap.x = screenWidth;
+        if (position.x > screenWidth) wrap.x = -screenWidth;
+        if (position.y < 0) wrap.y = screenHeight;
+        if (position.y > screenHeight) wrap.y = -screenHeight;
+        position += wrap;
+        previousPosition += wrap;
+    }
+    
+    Vector2 getRenderPosition(float alpha) const {
+        return lerp(previousPosition, position, alpha);
+    }
+    
+    float getRenderRotation(float alpha) const {
+        return lerp(previousRotation, rotation, alpha);
     }
     
-    virtual void render(SDL_Renderer* renderer) = 0;
+    virtual void render(SpriteBatch& batch, float alpha) = 0;
     virtual float getRadius() const = 0;
     virtual ~GameObject() {}
 };
@@ -60,13 +95,15 @@ public:
     float drag;
     int lives;
     bool invulnerable;
-    float invulnerableTime;
-    Texture* shipTexture;
+    TimerWheel& timers;
+    TimerHandle invulnerableTimer;
+    AtlasRegion shipSprite;
     
-    Ship(float x, float y, Texture* tex) : size(32.0f), thrusting(false), thrustPower(300.0f), 
-                             drag(0.99f), lives(3), invulnerable(true), invulnerableTime(3.0f),
-                             shipTexture(tex) {
+    Ship(float x, float y, const AtlasRegion& sprite, TimerWheel& timers) : size(32.0f), thrusting(false), thrustPower(300.0f), 
+                             drag(0.99f), lives(3), invulnerable(false), timers(timers),
+                             shipSprite(sprite) {
         position = Vector2(x, y);
+        makeInvulnerable();
     }
     
     void update(float dt, int screenWidth, int screenHeight) override {
@@ -93,39 +130,37 @@ public:
         velocity.x *= drag;
         velocity.y *= drag;
         
-        // Update invulnerability
-        if (invulnerable) {
-            invulnerableTime -= dt;
-            if (invulnerableTime <= 0) {
-                invulnerable = false;
-            }
-        }
-        
         GameObject::update(dt, screenWidth, screenHeight);
     }
     
-    void render(SDL_Renderer* renderer) override {
+    void render(SpriteBatch& batch, float alpha) override {
         if (invulnerable) {
-            int flash = (int)(invulnerableTime * 10) % 2;
+            int flash = (int)(timers.getRemaining(invulnerableTimer) * 10) % 2;
             if (flash == 0) return; // Blink when invulnerable
         }
         
+        Vector2 drawPosition = getRenderPosition(alpha);
+        float drawRotation = getRenderRotation(alpha);
+        
         // Render ship sprite with rotation
         // The sprite is drawn pointing right (0 degrees), so we add 90 to rotation
-        SDL_Rect destRect = { (int)(position.x - 42), (int)(position.y - 64), 85, 128 };
-        SDL_Point center = { 42, 64 };
-        SDL_RenderCopyEx(renderer, shipTexture->getSDLTexture(), nullptr, &destRect, 
-                        rotation + 90, &center, SDL_FLIP_NONE);
+        SDL_FRect destRect = { drawPosition.x - 42, drawPosition.y - 64, 85, 128 };
+        SDL_FPoint center = { 42, 64 };
+        batch.draw(shipSprite, destRect, drawRotation + 90, &center);
         
         // Thrust flame (still draw with lines for effect)
         if (thrusting) {
-            float rad = rotation * M_PI / 180.0f;
-            Vector2 back(position.x - cos(rad) * size * 0.8f, 
-                        position.y - sin(rad) * size * 0.8f);
-            Vector2 left(position.x + cos(rad + 2.5f) * size * 0.6f, 
-                        position.y + sin(rad + 2.5f) * size * 0.6f);
-            Vector2 right(position.x + cos(rad - 2.5f) * size * 0.6f, 
-                         position.y + sin(rad - 2.5f) * size * 0.6f);
+            // The lines go straight to the renderer, after the queued sprites
+            batch.flush();
+            SDL_Renderer* renderer = batch.getRenderer();
+            
+            float rad = drawRotation * M_PI / 180.0f;
+            Vector2 back(drawPosition.x - cos(rad) * size * 0.8f, 
+                        drawPosition.y - sin(rad) * size * 0.8f);
+            Vector2 left(drawPosition.x + cos(rad + 2.5f) * size * 0.6f, 
+                        drawPosition.y + sin(rad + 2.5f) * size * 0.6f);
+            Vector2 right(drawPosition.x + cos(rad - 2.5f) * size * 0.6f, 
+                         drawPosition.y + sin(rad - 2.5f) * size * 0.6f);
             
             SDL_SetRenderDrawColor(renderer, 255, 150, 0, 255);
             SDL_RenderDrawLine(renderer, left.x, left.y, back.x, back.y);
@@ -139,8 +174,15 @@ public:
         position = Vector2(x, y);
         velocity = Vector2(0, 0);
         rotation = 0;
+        makeInvulnerable();
+        savePreviousState();
+    }
+    
+    // Invulnerable for a few seconds after spawning
+    void makeInvulnerable() {
+        timers.cancel(invulnerableTimer);
         invulnerable = true;
-        invulnerableTime = 3.0f;
+        invulnerableTimer = timers.schedule(3.0f, [this]() { invulnerable = false; }, this);
     }
 };
 
@@ -148,38 +190,36 @@ public:
 class Bullet : public GameObject {
 public:
     float size;
-    float lifetime;
     float maxLifetime;
-    Texture* missileTexture;
+    TimerHandle lifetimeTimer;
+    AtlasRegion missileSprite;
     
-    Bullet(Texture* tex) : size(8.0f), lifetime(0), maxLifetime(2.0f), missileTexture(tex) {
+    Bullet(const AtlasRegion& sprite) : size(8.0f), maxLifetime(2.0f), missileSprite(sprite) {
         active = false;
     }
     
-    void fire(Vector2 pos, float rot, Vector2 shipVel) {
+    void fire(Vector2 pos, float rot, Vector2 shipVel, TimerWheel& timers) {
         position = pos;
         rotation = rot;
         float rad = rot * M_PI / 180.0f;
         velocity.x = cos(rad) * 500.0f + shipVel.x;
         velocity.y = sin(rad) * 500.0f + shipVel.y;
-        lifetime = 0;
         active = true;
+        savePreviousState();
+        
+        // Expire after maxLifetime; a bullet that hit something may be
+        // fired again before its old timer runs out
+        timers.cancel(lifetimeTimer);
+        lifetimeTimer = timers.schedule(maxLifetime, [this]() { active = false; }, this);
     }
     
-    void update(float dt, int screenWidth, int screenHeight) override {
-        lifetime += dt;
-        if (lifetime > maxLifetime) {
-            active = false;
-        }
-        GameObject::update(dt, screenWidth, screenHeight);
-    }
-    
-    void render(SDL_Renderer* renderer) override {
+    void render(SpriteBatch& batch, float alpha) override {
+        Vector2 drawPosition = getRenderPosition(alpha);
+        float drawRotation = getRenderRotation(alpha);
+        
         // Render missile sprite with rotation
-        SDL_Rect destRect = { (int)(position.x - 8), (int)(position.y - 8), 16, 16 };
-        SDL_Point center = { 8, 8 };
-        SDL_RenderCopyEx(renderer, missileTexture->getSDLTexture(), nullptr, &destRect, 
-                        rotation + 90, &center, SDL_FLIP_NONE);
+        SDL_FRect destRect = { drawPosition.x - 8, drawPosition.y - 8, 16, 16 };
+        batch.draw(missileSprite, destRect, drawRotation + 90);
     }
     
     float getRadius() const override { return size; }
@@ -193,11 +233,11 @@ public:
     
     enum Size { LARGE, MEDIUM, SMALL };
     Size asteroidSize;
-    Texture* texture;
+    AtlasRegion sprite;
     
-    Asteroid(Texture* largeTex, Texture* mediumTex, Texture* smallTex) 
-        : size(0), points(0), asteroidSize(LARGE), texture(nullptr),
-          largeTexture(largeTex), mediumTexture(mediumTex), smallTexture(smallTex) {
+    Asteroid(const AtlasRegion& large, const AtlasRegion& medium, const AtlasRegion& small)
+        : size(0), points(0), asteroidSize(LARGE),
+          largeSprite(large), mediumSprite(medium), smallSprite(small) {
         active = false;
     }
     
@@ -209,17 +249,17 @@ public:
             case LARGE:
                 size = 64.0f;
                 points = 20;
-                texture = largeTexture;
+                sprite = largeSprite;
                 break;
             case MEDIUM:
                 size = 32.0f;
                 points = 50;
-                texture = mediumTexture;
+                sprite = mediumSprite;
                 break;
             case SMALL:
                 size = 16.0f;
                 points = 100;
-                texture = smallTexture;
+                sprite = smallSprite;
                 break;
         }
         
@@ -234,9 +274,13 @@ public:
         
         rotationSpeed = randomFloat(-90, 90);
         active = true;
+        savePreviousState();
     }
     
-    void render(SDL_Renderer* renderer) override {
+    void render(SpriteBatch& batch, float alpha) override {
+        Vector2 drawPosition = getRenderPosition(alpha);
+        float drawRotation = getRenderRotation(alpha);
+        
         int spriteSize = 0;
         switch (asteroidSize) {
             case LARGE: spriteSize = 128; break;
@@ -244,19 +288,17 @@ public:
             case SMALL: spriteSize = 32; break;
         }
         
-        SDL_Rect destRect = { (int)(position.x - spriteSize/2), (int)(position.y - spriteSize/2), 
-                             spriteSize, spriteSize };
-        SDL_Point center = { spriteSize/2, spriteSize/2 };
-        SDL_RenderCopyEx(renderer, texture->getSDLTexture(), nullptr, &destRect, 
-                        rotation, &center, SDL_FLIP_NONE);
+        SDL_FRect destRect = { drawPosition.x - spriteSize / 2, drawPosition.y - spriteSize / 2,
+                               (float)spriteSize, (float)spriteSize };
+        batch.draw(sprite, destRect, drawRotation);
     }
     
     float getRadius() const override { return size; }
     
 private:
-    Texture* largeTexture;
-    Texture* mediumTexture;
-    Texture* smallTexture;
+    AtlasRegion largeSprite;
+    AtlasRegion mediumSprite;
+    AtlasRegion smallSprite;
 };
 
 // Check collision between two game objects
@@ -267,103 +309,196 @@ bool checkCollision(GameObject* a, GameObject* b) {
     return distance < (a->getRadius() + b->getRadius());
 }
 
-int main() {
+int main(int argc, char* argv[]) {
+    // --soak [seconds] plays unattended on a virtual clock as fast as possible
+    // --headless renders on the CPU without a display; implies --soak
+    // --capture <file.bmp> saves the last headless frame
+    // --renderer <driver> and --vsync off|on|adaptive pick the renderer setup
+    // --record [N] saves every Nth frame to captures/
+    // --low-latency samples input just before the next vblank
+    bool soakMode = false;
+    float soakSeconds = 600.0f;
+    bool headless = false;
+    std::string capturePath;
+    WindowConfig windowConfig("Game6 - Asteroids | ESC to Exit", 1920, 1080, false);
+    windowConfig.fullscreen = FullscreenMode::DESKTOP;
+    bool vsyncChosen = false;
+    unsigned int recordInterval = 0;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--soak") {
+            soakMode = true;
+            if (i + 1 < argc && std::atof(argv[i + 1]) > 0.0f) {
+                soakSeconds = static_cast<float>(std::atof(argv[++i]));
+            }
+        } else if (arg == "--headless") {
+            headless = true;
+        } else if (arg == "--capture" && i + 1 < argc) {
+            capturePath = argv[++i];
+        } else if (arg == "--renderer" && i + 1 < argc) {
+            windowConfig.renderDriver = argv[++i];
+        } else if (arg == "--vsync" && i + 1 < argc) {
+            std::string vsync = argv[++i];
+            windowConfig.vsync = vsync == "off" ? VSyncMode::OFF
+                               : vsync == "adaptive" ? VSyncMode::ADAPTIVE : VSyncMode::ON;
+            vsyncChosen = true;
+        } else if (arg == "--record") {
+            recordInterval = 1;
+            if (i + 1 < argc && std::atoi(argv[i + 1]) > 0) {
+                recordInterval = static_cast<unsigned int>(std::atoi(argv[++i]));
+            }
+        } else if (arg == "--low-latency") {
+            windowConfig.lowLatency = true;
+        }
+    }
+    // Nobody can press a key without a display
+    if (headless) {
+        soakMode = true;
+        windowConfig.mode = WindowMode::HEADLESS;
+    }
+    // Soak runs should not wait for the display unless asked to
+    if (soakMode && !vsyncChosen) {
+        windowConfig.vsync = VSyncMode::OFF;
+    }
+    
     Logger::getInstance().initialize();
     Logger::getInstance().info("=== Game6 - Asteroids with Sprites Starting ===");
+    Profiler::getInstance().initialize();
+    SamplingProfiler::getInstance().initialize();
+    FlightRecorder::getInstance().initialize();
     
     // Create fullscreen window
-    Window window("Game6 - Asteroids | ESC to Exit", 1920, 1080, false);
+    Window window(windowConfig);
     if (!window.initialize()) {
         Logger::getInstance().error("Failed to initialize window");
         return -1;
     }
+    if (recordInterval > 0) {
+        window.startCapture(FrameCaptureConfig("captures", CaptureFormat::PNG, recordInterval));
+    }
     
-    // Set fullscreen
-    SDL_SetWindowFullscreen(window.getSDLWindow(), SDL_WINDOW_FULLSCREEN_DESKTOP);
-    SDL_Delay(16);
+    // Fonts are opened by SDL_ttf as their files arrive
+    TextRenderer::getInstance().initialize();
     
-    // Load textures
-    Texture shipTexture;
-    Texture missileTexture;
-    Texture asteroidLargeTexture;
-    Texture asteroidMediumTexture;
-    Texture asteroidSmallTexture;
-    Texture spaceBackground;
+    // Decode every image and read the font on worker threads; the sprites
+    // then share one atlas page so SDL can batch them
+    const char* fontPath = "/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf";
+    AssetLoader assetLoader;
+    assetLoader.start();
     
-    if (!shipTexture.loadFromFile("assets/ship.png", window.getRenderer())) {
-        Logger::getInstance().error("Failed to load ship texture");
-        return -1;
-    }
-    if (!missileTexture.loadFromFile("assets/missile.png", window.getRenderer())) {
-        Logger::getInstance().error("Failed to load missile texture");
-        return -1;
-    }
-    if (!asteroidLargeTexture.loadFromFile("assets/asteroid_large.png", window.getRenderer())) {
-        Logger::getInstance().error("Failed to load large asteroid texture");
-        return -1;
+    const char* spriteNames[] = {"ship", "missile", "asteroid_large", "asteroid_medium", "asteroid_small"};
+    std::vector<AsyncAsset<SDL_Surface>> spriteImages;
+    for (const char* name : spriteNames) {
+        spriteImages.push_back(assetLoader.loadSurface(std::string("assets/") + name + ".png"));
     }
-    if (!asteroidMediumTexture.loadFromFile("assets/asteroid_medium.png", window.getRenderer())) {
-        Logger::getInstance().error("Failed to load medium asteroid texture");
-        return -1;
+    AsyncAsset<Texture> backgroundRequest = assetLoader.loadTexture("assets/space_bg.png", window.getRenderer());
+    AsyncAsset<Font> defaultFont = assetLoader.loadFont(fontPath, 24);
+    AsyncAsset<Font> largeFont = assetLoader.loadFont(fontPath, 48);
+    assetLoader.finish();
+    
+    TextureAtlas spriteAtlas;
+    for (size_t i = 0; i < spriteImages.size(); i++) {
+        if (!spriteAtlas.addSurface(spriteNames[i], spriteImages[i].get().get())) {
+            Logger::getInstance().error(std::string("Failed to load ") + spriteNames[i] + " texture");
+            return -1;
+        }
     }
-    if (!asteroidSmallTexture.loadFromFile("assets/asteroid_small.png", window.getRenderer())) {
-        Logger::getInstance().error("Failed to load small asteroid texture");
+    spriteImages.clear();
+    if (!spriteAtlas.build(window.getRenderer())) {
+        Logger::getInstance().error("Failed to build sprite atlas");
         return -1;
     }
-    if (!spaceBackground.loadFromFile("assets/space_bg.png", window.getRenderer())) {
+    AtlasRegion shipSprite = spriteAtlas.getRegion("ship");
+    std::shared_ptr<Texture> spaceBackground = backgroundRequest.get();
+    if (!spaceBackground) {
         Logger::getInstance().error("Failed to load space background texture");
         return -1;
     }
     
-    // Initialize text renderer
+    // Both sizes are already in the AssetCache
     TextRenderer& textRenderer = TextRenderer::getInstance();
-    textRenderer.initialize();
-    textRenderer.loadFont("default", "/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf", 24);
-    textRenderer.loadFont("large", "/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf", 48);
+    textRenderer.loadFont("default", fontPath, 24);
+    textRenderer.loadFont("large", fontPath, 48);
     
     TimeManager timeManager(60);
+    timeManager.setFixedTimestep(60.0f);
+    if (PerfCounters::initialize()) {
+        timeManager.enablePerfCounters();
+    }
+    
+    if (soakMode) {
+        // Same seed and same deltas every run
+        timeManager.useVirtualClock(1.0f / 60.0f);
+        gen.seed(12345);
+        srand(12345);
+        Logger::getInstance().info("Soak test: " + std::to_string(soakSeconds) + " simulated seconds");
+    }
+    auto wallStart = std::chrono::steady_clock::now();
+    double renderSeconds = 0.0;
+    int renderedFrames = 0;
     
     int screenWidth = window.getWidth();
     int screenHeight = window.getHeight();
     
+    // The background never changes: scale it to the screen once and copy
+    // the cached layer without blending after that
+    LayerStack layers(window);
+    RenderLayer& backgroundLayer = layers.addLayer("background", 0, [&spaceBackground, &window](SDL_Renderer* renderer) {
+        SDL_Rect bgRect = { 0, 0, window.getWidth(), window.getHeight() };
+        SDL_RenderCopy(renderer, spaceBackground->getSDLTexture(), nullptr, &bgRect);
+    });
+    backgroundLayer.setOpaque(true);
+    
     // Game objects
-    Ship ship(screenWidth / 2, screenHeight / 2, &shipTexture);
+    TimerWheel& timers = timeManager.getTimers();
+    Ship ship(screenWidth / 2, screenHeight / 2, shipSprite, timers);
     ship.rotation = -90;  // Point upward
-    std::vector<Bullet> bullets;
-    for (int i = 0; i < 20; i++) {
-        bullets.push_back(Bullet(&missileTexture));
-    }
-    
-    std::vector<Asteroid> asteroids;
-    for (int i = 0; i < 50; i++) {
-        asteroids.push_back(Asteroid(&asteroidLargeTexture, &asteroidMediumTexture, &asteroidSmallTexture));
-    }
+    ship.savePreviousState();
+    AtlasRegion missileSprite = spriteAtlas.getRegion("missile");
+    AtlasRegion asteroidLargeSprite = spriteAtlas.getRegion("asteroid_large");
+    AtlasRegion asteroidMediumSprite = spriteAtlas.getRegion("asteroid_medium");
+    AtlasRegion asteroidSmallSprite = spriteAtlas.getRegion("asteroid_small");
+    
+    // The pools grow when everything in them is in use. A deque keeps the
+    // objects where they are, so the timers holding them stay valid.
+    std::deque<Bullet> bullets(20, Bullet(missileSprite));
+    std::deque<Asteroid> asteroids(50, Asteroid(asteroidLargeSprite, asteroidMediumSprite, asteroidSmallSprite));
+    auto acquireBullet = [&]() -> Bullet& {
+        for (auto& bullet : bullets) {
+            if (!bullet.active) return bullet;
+        }
+        bullets.push_back(Bullet(missileSprite));
+        return bullets.back();
+    };
+    auto acquireAsteroid = [&]() -> Asteroid& {
+        for (auto& asteroid : asteroids) {
+            if (!asteroid.active) return asteroid;
+        }
+        asteroids.push_back(Asteroid(asteroidLargeSprite, asteroidMediumSprite, asteroidSmallSprite));
+        return asteroids.back();
+    };
+    SpriteBatch spriteBatch;
     
     // Game state
     int score = 0;
     int level = 1;
     bool gameOver = false;
-    float shootCooldown = 0;
+    bool canShoot = true;
     const float SHOOT_DELAY = 0.25f;
     
     // Spawn initial asteroids
     auto spawnLevel = [&](int numAsteroids) {
         for (int i = 0; i < numAsteroids; i++) {
-            for (auto& asteroid : asteroids) {
-                if (!asteroid.active) {
-                    // Spawn at edges
-                    Vector2 pos;
-                    if (rand() % 2 == 0) {
-                        pos.x = (rand() % 2 == 0) ? 0 : screenWidth;
-                        pos.y = randomFloat(0, screenHeight);
-                    } else {
-                        pos.x = randomFloat(0, screenWidth);
-                        pos.y = (rand() % 2 == 0) ? 0 : screenHeight;
-                    }
-                    asteroid.spawn(pos, Asteroid::LARGE);
-                    break;
-                }
+            // Spawn at edges
+            Vector2 pos;
+            if (rand() % 2 == 0) {
+                pos.x = (rand() % 2 == 0) ? 0 : screenWidth;
+                pos.y = randomFloat(0, screenHeight);
+            } else {
+                pos.x = randomFloat(0, screenWidth);
+                pos.y = (rand() % 2 == 0) ? 0 : screenHeight;
             }
+            acquireAsteroid().spawn(pos, Asteroid::LARGE);
         }
     };
     
@@ -373,6 +508,11 @@ int main() {
     
     // Main game loop
     while (window.isRunning()) {
+        ENGAIN_PROFILE_SCOPE("Frame");
+        if (soakMode && timeManager.getTotalTime() >= soakSeconds) {
+            break;
+        }
+        
         window.handleEvents();
         Input::getInstance().update();
         
@@ -381,161 +521,178 @@ int main() {
             break;
         }
         
-        timeManager.update();
-        float dt = timeManager.getDeltaTime();
-        if (dt > 0.1f) dt = 0.1f;
+        // F12 saves a screenshot
+        if (Input::getInstance().isKeyPressed(SDLK_F12)) {
+            window.takeScreenshot();
+        }
         
-        shootCooldown -= dt;
+        timeManager.update();
         
-        if (!gameOver) {
-            // Update ship
-            ship.update(dt, screenWidth, screenHeight);
+        // Game over - restart with R
+        if (gameOver && (soakMode || Input::getInstance().isKeyPressed(SDLK_r))) {
+            ship.lives = 3;
+            ship.reset(screenWidth / 2, screenHeight / 2);
+            score = 0;
+            level = 1;
+            gameOver = false;
             
-            // Shoot
-            if ((Input::getInstance().isKeyDown(SDLK_SPACE) || 
-                 Input::getInstance().isKeyDown(SDLK_RETURN)) && shootCooldown <= 0) {
-                for (auto& bullet : bullets) {
-                    if (!bullet.active) {
-                        float rad = ship.rotation * M_PI / 180.0f;
-                        // Fire from the front of the ship sprite (32 pixels from center)
-                        Vector2 gunPos(ship.position.x + cos(rad) * 32.0f,
-                                      ship.position.y + sin(rad) * 32.0f);
-                        bullet.fire(gunPos, ship.rotation, ship.velocity);
-                        shootCooldown = SHOOT_DELAY;
-                        break;
-                    }
-                }
-            }
-            
-            // Update bullets
+            // Clear all
             for (auto& bullet : bullets) {
-                if (bullet.active) {
-                    bullet.update(dt, screenWidth, screenHeight);
-                }
+                bullet.active = false;
+                timers.cancelOwner(&bullet);
             }
+            canShoot = true;
+            for (auto& asteroid : asteroids) asteroid.active = false;
             
-            // Update asteroids
-            for (auto& asteroid : asteroids) {
-                if (asteroid.active) {
-                    asteroid.update(dt, screenWidth, screenHeight);
-                }
-            }
+            spawnLevel(3 + level);
+        }
+        
+        // Run the simulation in fixed steps
+        while (timeManager.consumeFixedStep()) {
+            ENGAIN_PERF_SCOPE("Simulation step");
+            float dt = timeManager.getFixedDeltaTime();
             
-            // Check bullet-asteroid collisions
-            for (auto& bullet : bullets) {
-                if (!bullet.active) continue;
+            ship.savePreviousState();
+            for (auto& bullet : bullets) bullet.savePreviousState();
+            for (auto& asteroid : asteroids) asteroid.savePreviousState();
+            
+            if (!gameOver) {
+                // Update ship
+                ship.update(dt, screenWidth, screenHeight);
+                
+                // Shoot
+                if ((soakMode || Input::getInstance().isKeyDown(SDLK_SPACE) || 
+                     Input::getInstance().isKeyDown(SDLK_RETURN)) && canShoot) {
+                    float rad = ship.rotation * M_PI / 180.0f;
+                    // Fire from the front of the ship sprite (32 pixels from center)
+                    Vector2 gunPos(ship.position.x + cos(rad) * 32.0f,
+                                  ship.position.y + sin(rad) * 32.0f);
+                    acquireBullet().fire(gunPos, ship.rotation, ship.velocity, timers);
+                    canShoot = false;
+                    timers.schedule(SHOOT_DELAY, [&canShoot]() { canShoot = true; });
+                }
+                
+                // Update bullets
+                for (auto& bullet : bullets) {
+                    if (bullet.active) {
+                        bullet.update(dt, screenWidth, screenHeight);
+                    }
+                }
                 
+                // Update asteroids
                 for (auto& asteroid : asteroids) {
-                    if (!asteroid.active) continue;
+                    if (asteroid.active) {
+                        asteroid.update(dt, screenWidth, screenHeight);
+                    }
+                }
+                
+                // Check bullet-asteroid collisions
+                ENGAIN_PERF_SCOPE("Collisions");
+                for (auto& bullet : bullets) {
+                    if (!bullet.active) continue;
                     
-                    if (checkCollision(&bullet, &asteroid)) {
-                        bullet.active = false;
-                        asteroid.active = false;
-                        score += asteroid.points;
+                    // Splitting adds to the pool, so no iterators here
+                    for (size_t a = 0; a < asteroids.size(); a++) {
+                        Asteroid& asteroid = asteroids[a];
+                        if (!asteroid.active) continue;
                         
-                        // Split asteroid if not small
-                        if (asteroid.asteroidSize == Asteroid::LARGE) {
-                            for (int i = 0; i < 2; i++) {
-                                for (auto& newAst : asteroids) {
-                                    if (!newAst.active) {
-                                        float angle = randomFloat(0, 2 * M_PI);
-                                        float speed = randomFloat(60, 120);
-                                        Vector2 vel(cos(angle) * speed, sin(angle) * speed);
-                                        newAst.spawn(asteroid.position, Asteroid::MEDIUM, vel);
-                                        break;
-                                    }
+                        if (checkCollision(&bullet, &asteroid)) {
+                            bullet.active = false;
+                            asteroid.active = false;
+                            score += asteroid.points;
+                            
+                            // Split asteroid if not small
+                            if (asteroid.asteroidSize == Asteroid::LARGE) {
+                                for (int i = 0; i < 2; i++) {
+                                    float angle = randomFloat(0, 2 * M_PI);
+                                    float speed = randomFloat(60, 120);
+                                    Vector2 vel(cos(angle) * speed, sin(angle) * speed);
+                                    acquireAsteroid().spawn(asteroid.position, Asteroid::MEDIUM, vel);
                                 }
-                            }
-                        } else if (asteroid.asteroidSize == Asteroid::MEDIUM) {
-                            for (int i = 0; i < 2; i++) {
-                                for (auto& newAst : asteroids) {
-                                    if (!newAst.active) {
-                                        float angle = randomFloat(0, 2 * M_PI);
-                                        float speed = randomFloat(80, 150);
-                                        Vector2 vel(cos(angle) * speed, sin(angle) * speed);
-                                        newAst.spawn(asteroid.position, Asteroid::SMALL, vel);
-                                        break;
-                                    }
+                            } else if (asteroid.asteroidSize == Asteroid::MEDIUM) {
+                                for (int i = 0; i < 2; i++) {
+                                    float angle = randomFloat(0, 2 * M_PI);
+                                    float speed = randomFloat(80, 150);
+                                    Vector2 vel(cos(angle) * speed, sin(angle) * speed);
+                                    acquireAsteroid().spawn(asteroid.position, Asteroid::SMALL, vel);
                                 }
                             }
+                            break;
                         }
-                        break;
                     }
                 }
-            }
-            
-            // Check ship-asteroid collisions
-            if (!ship.invulnerable) {
-                for (auto& asteroid : asteroids) {
-                    if (asteroid.active && checkCollision(&ship, &asteroid)) {
-                        ship.lives--;
-                        if (ship.lives > 0) {
-                            ship.reset(screenWidth / 2, screenHeight / 2);
-                        } else {
-                            gameOver = true;
+                
+                // Check ship-asteroid collisions
+                if (!ship.invulnerable) {
+                    for (auto& asteroid : asteroids) {
+                        if (asteroid.active && checkCollision(&ship, &asteroid)) {
+                            ship.lives--;
+                            if (ship.lives > 0) {
+                                ship.reset(screenWidth / 2, screenHeight / 2);
+                            } else {
+                                gameOver = true;
+                            }
+                            break;
                         }
-                        break;
                     }
                 }
-            }
-            
-            // Check if level complete
-            bool allClear = true;
-            for (const auto& asteroid : asteroids) {
-                if (asteroid.active) {
-                    allClear = false;
-                    break;
-                }
-            }
-            
-            if (allClear) {
-                level++;
-                spawnLevel(3 + level);
-            }
-        } else {
-            // Game over - restart with R
-            if (Input::getInstance().isKeyPressed(SDLK_r)) {
-                ship.lives = 3;
-                ship.reset(screenWidth / 2, screenHeight / 2);
-                score = 0;
-                level = 1;
-                gameOver = false;
                 
-                // Clear all
-                for (auto& bullet : bullets) bullet.active = false;
-                for (auto& asteroid : asteroids) asteroid.active = false;
+                // Check if level complete
+                bool allClear = true;
+                for (const auto& asteroid : asteroids) {
+                    if (asteroid.active) {
+                        allClear = false;
+                        break;
+                    }
+                }
                 
-                spawnLevel(3 + level);
+                if (allClear) {
+                    level++;
+                    spawnLevel(3 + level);
+                }
             }
         }
         
+        // Soak runs only draw once per simulated second, except headless
+        // ones, which draw every frame to measure the CPU render cost
+        if (soakMode && !headless && timeManager.getFrameCount() % 60 != 0) {
+            continue;
+        }
+        
         // Render
+        ENGAIN_PROFILE_SCOPE("Render");
+        auto renderStart = std::chrono::steady_clock::now();
+        float alpha = timeManager.getInterpolationAlpha();
         SDL_Renderer* renderer = window.getRenderer();
         
         // Draw space background
-        SDL_Rect bgRect = { 0, 0, screenWidth, screenHeight };
-        SDL_RenderCopy(renderer, spaceBackground.getSDLTexture(), nullptr, &bgRect);
+        layers.render();
+        
+        // Sprites share the atlas page, so they go out in one geometry call
+        spriteBatch.begin(renderer);
         
         // Draw asteroids
         for (auto& asteroid : asteroids) {
             if (asteroid.active) {
-                asteroid.render(renderer);
+                asteroid.render(spriteBatch, alpha);
             }
         }
         
         // Draw bullets
         for (auto& bullet : bullets) {
             if (bullet.active) {
-                bullet.render(renderer);
+                bullet.render(spriteBatch, alpha);
             }
         }
         
         // Draw ship
         if (!gameOver) {
-            ship.render(renderer);
+            ship.render(spriteBatch, alpha);
         }
+        spriteBatch.end();
         
         // Draw UI
+        ENGAIN_PROFILE_SCOPE("HUD");
         std::ostringstream scoreText;
         scoreText << "SCORE: " << score;
         textRenderer.drawText(renderer, scoreText.str(), 20, 20, "default", 
@@ -549,7 +706,18 @@ int main() {
         // Draw lives (using ship sprite icons)
         for (int i = 0; i < ship.lives; i++) {
             SDL_Rect lifeRect = { 20 + i * 30, 85, 24, 24 };
-            SDL_RenderCopy(renderer, shipTexture.getSDLTexture(), nullptr, &lifeRect);
+            Texture::renderEx(renderer, shipSprite, lifeRect);
+        }
+        
+        if (timeManager.hasPerfCounters()) {
+            const PerfCounterValues& counters = timeManager.getAverageFrameCounters();
+            std::ostringstream perfText;
+            perfText << std::fixed << std::setprecision(2) << "IPC: " << counters.getIPC()
+                     << "  L1d misses: " << counters[PerfEvent::L1D_MISSES]
+                     << "  LLC misses: " << counters[PerfEvent::LLC_MISSES]
+                     << "  branch misses: " << counters[PerfEvent::BRANCH_MISSES];
+            textRenderer.drawText(renderer, perfText.str(), 20, screenHeight - 40, "default",
+                                 SDL_Color{255, 255, 255, 255});
         }
         
         if (gameOver) {
@@ -563,10 +731,41 @@ int main() {
         }
         
         window.present();
+        renderSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - renderStart).count();
+        renderedFrames++;
+    }
+    
+    if (headless && !capturePath.empty()) {
+        window.saveFrame(capturePath);
     }
     
     Logger::getInstance().info("Game ended");
+    if (timeManager.hasPerfCounters()) {
+        PerfCounters::forCurrentThread()->logScopeReport();
+    }
+    assetLoader.logReport();
+    AssetCache::getInstance().logReport();
+    FlightRecorder::getInstance().shutdown();
+    SamplingProfiler::getInstance().shutdown();
+    Profiler::getInstance().shutdown();
     Logger::getInstance().info("Final score: " + std::to_string(score));
     
+    if (soakMode) {
+        float wallSeconds = std::chrono::duration<float>(std::chrono::steady_clock::now() - wallStart).count();
+        std::ostringstream report;
+        report << std::fixed << std::setprecision(2)
+               << "Soak finished: " << timeManager.getFrameCount() << " frames, "
+               << timeManager.getTotalTime() << " s simulated in " << wallSeconds << " s ("
+               << timeManager.getTotalTime() / wallSeconds << "x), reached level " << level;
+        Logger::getInstance().info(report.str());
+    }
+    if (headless && renderedFrames > 0) {
+        std::ostringstream report;
+        report << std::fixed << std::setprecision(3)
+               << "Headless render: " << renderedFrames << " frames, "
+               << renderSeconds * 1000.0 / renderedFrames << " ms CPU per frame";
+        Logger::getInstance().info(report.str());
+    }
+    
     return 0;
 }
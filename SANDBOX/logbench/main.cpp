@@ -0,0 +1,144 @@
+#include "../ENGAIN/core/Logger.h"
+#include "../ENGAIN/core/BinaryLog.h"
+#include "../ENGAIN/core/LogThrottle.h"
+#include <chrono>
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <string>
+
+using namespace ENGAIN;
+
+// Measures how long Logger::debug/info take on the calling thread for the
+// synchronous path and for each asynchronous overflow policy.
+
+enum class BenchMode {
+    TEXT,
+    STRUCTURED,
+    THROTTLED
+};
+
+struct BenchResult {
+    double meanNs;
+    double p50Ns;
+    double p99Ns;
+    double maxNs;
+};
+
+BenchResult runBench(int messagesPerThread, int threadCount, BenchMode benchMode) {
+    std::vector<std::vector<double>> samples(threadCount);
+    std::vector<std::thread> threads;
+    
+    for (int t = 0; t < threadCount; t++) {
+        threads.emplace_back([&, t]() {
+            std::vector<double>& out = samples[t];
+            out.reserve(messagesPerThread);
+            std::string message = "Loaded texture: assets/asteroid_medium.png (thread " +
+                                  std::to_string(t) + ")";
+            
+            for (int i = 0; i < messagesPerThread; i++) {
+                auto start = std::chrono::steady_clock::now();
+                if (benchMode == BenchMode::STRUCTURED) {
+                    ENGAIN_LOGF_DEBUG(ASSETS, "Loaded texture: {} ({} of {})", "assets/asteroid_medium.png", i, t);
+                } else if (benchMode == BenchMode::THROTTLED) {
+                    ENGAIN_LOG_THROTTLED(LogLevel::DEBUG, ASSETS, 5, 1.0f, message);
+                } else {
+                    Logger::getInstance().debug(message);
+                }
+                auto end = std::chrono::steady_clock::now();
+                out.push_back(std::chrono::duration<double, std::nano>(end - start).count());
+            }
+        });
+    }
+    
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    
+    std::vector<double> all;
+    for (auto& s : samples) {
+        all.insert(all.end(), s.begin(), s.end());
+    }
+    std::sort(all.begin(), all.end());
+    
+    double sum = 0.0;
+    for (double v : all) sum += v;
+    
+    BenchResult result;
+    result.meanNs = sum / all.size();
+    result.p50Ns = all[all.size() / 2];
+    result.p99Ns = all[all.size() * 99 / 100];
+    result.maxNs = all.back();
+    return result;
+}
+
+void printResult(const std::string& name, const BenchResult& result) {
+    std::cout << std::left << std::setw(28) << name << std::right << std::fixed << std::setprecision(0)
+              << std::setw(10) << result.meanNs
+              << std::setw(10) << result.p50Ns
+              << std::setw(10) << result.p99Ns
+              << std::setw(12) << result.maxNs << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    int messages = argc > 1 ? std::stoi(argv[1]) : 100000;
+    int threadCount = argc > 2 ? std::stoi(argv[2]) : 1;
+    
+    std::cout << "Logger caller-thread cost, " << messages << " messages x "
+              << threadCount << " thread(s)" << std::endl;
+    std::cout << std::left << std::setw(28) << "mode" << std::right
+              << std::setw(10) << "mean ns" << std::setw(10) << "p50 ns"
+              << std::setw(10) << "p99 ns" << std::setw(12) << "max ns" << std::endl;
+    
+    // Each mode needs a fresh Logger, so run one mode per process when asked
+    std::string mode = argc > 3 ? argv[3] : "";
+    
+    Logger& logger = Logger::getInstance();
+    logger.initialize("logs/bench");
+    
+    if (mode.empty() || mode == "sync") {
+        printResult("sync", runBench(messages, threadCount, BenchMode::TEXT));
+        if (!mode.empty()) return 0;
+    }
+    
+    if (mode == "throttled") {
+        printResult("throttled (5/s)", runBench(messages, threadCount, BenchMode::THROTTLED));
+        return 0;
+    }
+    
+    if (mode == "binary") {
+        BinaryLog& binaryLog = BinaryLog::getInstance();
+        binaryLog.open("logs/bench");
+        printResult("binary", runBench(messages, threadCount, BenchMode::STRUCTURED));
+        binaryLog.close();
+        std::cout << "binary bytes written: " << binaryLog.getBytesWritten() << std::endl;
+        return 0;
+    }
+    
+    LogOverflowPolicy policy = LogOverflowPolicy::DROP;
+    std::string policyName = "drop";
+    if (mode == "block") {
+        policy = LogOverflowPolicy::BLOCK;
+        policyName = "block";
+    } else if (mode == "overwrite") {
+        policy = LogOverflowPolicy::OVERWRITE_OLDEST;
+        policyName = "overwrite";
+    }
+    
+    logger.enableAsync(8192, policy);
+    BenchResult result = runBench(messages, threadCount, BenchMode::TEXT);
+    printResult("async (" + policyName + ")", result);
+    
+    auto flushStart = std::chrono::steady_clock::now();
+    logger.flush();
+    auto flushEnd = std::chrono::steady_clock::now();
+    
+    std::cout << "dropped: " << logger.getDroppedCount() << ", drain time: "
+              << std::chrono::duration<double, std::milli>(flushEnd - flushStart).count()
+              << " ms" << std::endl;
+    
+    logger.shutdown();
+    return 0;
+}
@@ -0,0 +1,99 @@
+#include "../ENGAIN/core/Logger.h"
+#include "../ENGAIN/core/TimeManager.h"
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ENGAIN;
+
+// Compares frame pacing of TimeManager::limitFPS against a plain
+// sleep_for of the remaining frame time, with a few ms of fake work per frame.
+
+using SteadyClock = std::chrono::steady_clock;
+
+void simulateWork(std::mt19937& rng) {
+    std::uniform_int_distribution<int> workMicros(2000, 8000);
+    auto until = SteadyClock::now() + std::chrono::microseconds(workMicros(rng));
+    while (SteadyClock::now() < until) {
+    }
+}
+
+void printStats(const std::string& name, const std::vector<double>& frameTimes, double targetMs) {
+    double sum = 0.0;
+    double maxError = 0.0;
+    for (double frameTime : frameTimes) {
+        sum += frameTime;
+        maxError = std::max(maxError, std::abs(frameTime - targetMs));
+    }
+    double mean = sum / frameTimes.size();
+    
+    double variance = 0.0;
+    for (double frameTime : frameTimes) {
+        variance += (frameTime - mean) * (frameTime - mean);
+    }
+    double stddev = std::sqrt(variance / (frameTimes.size() - 1));
+    
+    std::cout << std::left << std::setw(12) << name << std::right << std::fixed << std::setprecision(3)
+              << std::setw(12) << mean
+              << std::setw(12) << stddev
+              << std::setw(14) << maxError << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    int targetFPS = argc > 1 ? std::stoi(argv[1]) : 60;
+    int frames = argc > 2 ? std::stoi(argv[2]) : 600;
+    double targetMs = 1000.0 / targetFPS;
+    
+    std::cout << "Frame pacing at " << targetFPS << " FPS over " << frames << " frames" << std::endl;
+    std::cout << std::left << std::setw(12) << "limiter" << std::right
+              << std::setw(12) << "mean ms" << std::setw(12) << "jitter ms"
+              << std::setw(14) << "max err ms" << std::endl;
+    
+    std::mt19937 rng(1234);
+    
+    // Old behaviour: sleep for whatever is left of the frame
+    {
+        std::vector<double> frameTimes;
+        auto last = SteadyClock::now();
+        for (int i = 0; i < frames; i++) {
+            simulateWork(rng);
+            auto elapsed = std::chrono::duration<double, std::milli>(SteadyClock::now() - last).count();
+            if (elapsed < targetMs) {
+                std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(targetMs - elapsed));
+            }
+            auto now = SteadyClock::now();
+            frameTimes.push_back(std::chrono::duration<double, std::milli>(now - last).count());
+            last = now;
+        }
+        printStats("sleep_for", frameTimes, targetMs);
+    }
+    
+    // TimeManager hybrid sleep/spin against absolute deadlines
+    {
+        TimeManager timeManager(targetFPS);
+        std::vector<double> frameTimes;
+        timeManager.update();
+        timeManager.getFrameStats().reset();
+        for (int i = 0; i < frames; i++) {
+            simulateWork(rng);
+            timeManager.limitFPS();
+            timeManager.update();
+            frameTimes.push_back(timeManager.getDeltaTime() * 1000.0);
+        }
+        printStats("hybrid", frameTimes, targetMs);
+        
+        const FrameStats::Summary& summary = timeManager.getFrameStats().getSummary();
+        std::cout << "learned oversleep: " << std::setprecision(3)
+                  << timeManager.getOversleepEstimate() * 1000.0f << " ms" << std::endl;
+        std::cout << "p50 " << summary.p50 * 1000.0f << " ms, p99 " << summary.p99 * 1000.0f
+                  << " ms, max " << summary.max * 1000.0f << " ms, 1% low " << std::setprecision(1)
+                  << summary.low1 << " FPS, over budget " << summary.overBudget << std::endl;
+    }
+    
+    return 0;
+}
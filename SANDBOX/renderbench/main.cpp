@@ -0,0 +1,223 @@
+#include "../ENGAIN/core/Logger.h"
+#include "../ENGAIN/core/Window.h"
+#include "../ENGAIN/core/Texture.h"
+#include "../ENGAIN/core/TextureAtlas.h"
+#include "../ENGAIN/core/SpriteBatch.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace ENGAIN;
+
+// Draws the same sprite scene with every render driver SDL offers, vsync off,
+// and reports the CPU time per frame (draw calls plus present). Each driver
+// runs the scene three ways: a copy per sprite from separate textures, a
+// copy per sprite from one atlas, and the atlas through a SpriteBatch. It
+// counts texture switches and draw calls per frame.
+
+using SteadyClock = std::chrono::steady_clock;
+
+struct Sprite {
+    float x, y;
+    float angle;
+    float spin;
+    int texture;
+};
+
+enum class SceneMode {
+    SEPARATE,
+    ATLAS,
+    BATCH
+};
+
+const char* modeName(SceneMode mode) {
+    switch (mode) {
+        case SceneMode::SEPARATE: return "separate";
+        case SceneMode::ATLAS: return "atlas";
+        case SceneMode::BATCH: return "batch";
+    }
+    return "";
+}
+
+struct BenchResult {
+    std::string renderer;
+    SceneMode mode;
+    int textureSwitches;    // Per frame
+    int drawCalls;          // Per frame, background included
+    double meanMs;
+    double maxMs;
+};
+
+bool runScene(const WindowConfig& config, const std::vector<Sprite>& sprites, int frames, SceneMode mode,
+              BenchResult& result) {
+    Window window(config);
+    if (!window.initialize()) {
+        return false;
+    }
+    SDL_Renderer* renderer = window.getRenderer();
+    
+    Texture background;
+    Texture textures[3];
+    TextureAtlas atlas;
+    AtlasRegion regions[3];
+    SpriteBatch batch(sprites.size());
+    bool useAtlas = mode != SceneMode::SEPARATE;
+    const char* texturePaths[3] = {
+        "assets/asteroid_large.png", "assets/asteroid_medium.png", "assets/asteroid_small.png"
+    };
+    if (!background.loadFromFile("assets/space_bg.png", renderer)) {
+        return false;
+    }
+    for (int i = 0; i < 3; i++) {
+        bool loaded = useAtlas ? atlas.addImage(texturePaths[i], texturePaths[i])
+                               : textures[i].loadFromFile(texturePaths[i], renderer);
+        if (!loaded) {
+            return false;
+        }
+    }
+    if (useAtlas && !atlas.build(renderer)) {
+        return false;
+    }
+    for (int i = 0; i < 3; i++) {
+        regions[i] = useAtlas ? atlas.getRegion(texturePaths[i]) : textures[i].getRegion();
+    }
+    
+    const int warmupFrames = 30;
+    double totalMs = 0.0;
+    double maxMs = 0.0;
+    int switches = 0;
+    int drawCalls = 0;
+    for (int frame = 0; frame < warmupFrames + frames; frame++) {
+        auto start = SteadyClock::now();
+        
+        window.handleEvents();
+        window.clear();
+        SDL_Rect backgroundRect = {0, 0, window.getWidth(), window.getHeight()};
+        SDL_RenderCopy(renderer, background.getSDLTexture(), nullptr, &backgroundRect);
+        SDL_Texture* bound = background.getSDLTexture();
+        switches = 0;
+        if (mode == SceneMode::BATCH) {
+            batch.begin(renderer);
+            for (const Sprite& sprite : sprites) {
+                batch.draw(regions[sprite.texture], sprite.x, sprite.y, sprite.angle + sprite.spin * frame);
+            }
+            batch.end();
+            switches = regions[0].texture != bound ? 1 : 0;
+            drawCalls = 1 + static_cast<int>(batch.getDrawCallCount());
+        } else {
+            for (const Sprite& sprite : sprites) {
+                const AtlasRegion& region = regions[sprite.texture];
+                if (region.texture != bound) {
+                    bound = region.texture;
+                    switches++;
+                }
+                SDL_Rect rect = {static_cast<int>(sprite.x) - region.getWidth() / 2,
+                                 static_cast<int>(sprite.y) - region.getHeight() / 2,
+                                 region.getWidth(), region.getHeight()};
+                Texture::renderEx(renderer, region, rect, sprite.angle + sprite.spin * frame);
+            }
+            drawCalls = 1 + static_cast<int>(sprites.size());
+        }
+        window.present();
+        
+        double ms = std::chrono::duration<double, std::milli>(SteadyClock::now() - start).count();
+        if (frame >= warmupFrames) {
+            totalMs += ms;
+            maxMs = std::max(maxMs, ms);
+        }
+    }
+    
+    result.renderer = window.getRendererName();
+    result.mode = mode;
+    result.textureSwitches = switches;
+    result.drawCalls = drawCalls;
+    result.meanMs = totalMs / frames;
+    result.maxMs = maxMs;
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    // renderbench [sprites] [frames] [--headless] [--driver name] [--batch-only]
+    // --batch-only skips the per-sprite copies, which crawl at 100k sprites
+    int spriteCount = 2000;
+    int frames = 600;
+    bool headless = false;
+    std::string onlyDriver;
+    bool batchOnly = false;
+    int positional = 0;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--headless") {
+            headless = true;
+        } else if (arg == "--driver" && i + 1 < argc) {
+            onlyDriver = argv[++i];
+        } else if (arg == "--batch-only") {
+            batchOnly = true;
+        } else if (positional++ == 0) {
+            spriteCount = std::stoi(arg);
+        } else {
+            frames = std::stoi(arg);
+        }
+    }
+    
+    Logger::getInstance().initialize();
+    
+    const int width = 1280;
+    const int height = 720;
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> xDist(0.0f, width);
+    std::uniform_real_distribution<float> yDist(0.0f, height);
+    std::uniform_real_distribution<float> angleDist(0.0f, 360.0f);
+    std::uniform_real_distribution<float> spinDist(-3.0f, 3.0f);
+    std::vector<Sprite> sprites(spriteCount);
+    for (Sprite& sprite : sprites) {
+        sprite = Sprite{xDist(rng), yDist(rng), angleDist(rng), spinDist(rng), static_cast<int>(rng() % 3)};
+    }
+    
+    std::vector<WindowConfig> configs;
+    if (headless) {
+        WindowConfig config("ENGAIN renderbench", width, height, false);
+        config.mode = WindowMode::HEADLESS;
+        configs.push_back(config);
+    } else {
+        for (const std::string& driver : Window::getRenderDrivers()) {
+            if (!onlyDriver.empty() && driver != onlyDriver) continue;
+            WindowConfig config("ENGAIN renderbench - " + driver, width, height, false);
+            config.renderDriver = driver;
+            config.vsync = VSyncMode::OFF;
+            configs.push_back(config);
+        }
+    }
+    
+    std::vector<BenchResult> results;
+    for (const WindowConfig& config : configs) {
+        for (SceneMode mode : {SceneMode::SEPARATE, SceneMode::ATLAS, SceneMode::BATCH}) {
+            if (batchOnly && mode != SceneMode::BATCH) continue;
+            BenchResult result;
+            if (runScene(config, sprites, frames, mode, result)) {
+                results.push_back(result);
+            } else {
+                std::cout << "Skipping " << (config.renderDriver.empty() ? "headless" : config.renderDriver)
+                          << " " << modeName(mode) << ": setup failed, see log" << std::endl;
+            }
+        }
+    }
+    
+    std::cout << spriteCount << " sprites at " << width << "x" << height << ", " << frames << " frames" << std::endl;
+    std::cout << std::left << std::setw(14) << "renderer" << std::setw(10) << "mode" << std::right
+              << std::setw(12) << "switches" << std::setw(12) << "calls" << std::setw(12) << "mean ms"
+              << std::setw(12) << "max ms" << std::endl;
+    for (const BenchResult& result : results) {
+        std::cout << std::left << std::setw(14) << result.renderer
+                  << std::setw(10) << modeName(result.mode) << std::right
+                  << std::setw(12) << result.textureSwitches << std::setw(12) << result.drawCalls << std::fixed
+                  << std::setprecision(3) << std::setw(12) << result.meanMs
+                  << std::setw(12) << result.maxMs << std::endl;
+    }
+    
+    return 0;
+}
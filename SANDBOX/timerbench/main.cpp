@@ -0,0 +1,74 @@
+#include "../ENGAIN/core/TimerWheel.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace ENGAIN;
+
+// Compares per-frame countdown timers (a float decremented every frame, the
+// way the games used to track cooldowns) against TimerWheel, with many
+// long-lived repeating timers of which only a few expire each frame.
+
+using SteadyClock = std::chrono::steady_clock;
+
+void printResult(const std::string& name, double seconds, int frames, long long fired) {
+    std::cout << std::left << std::setw(12) << name << std::right << std::fixed << std::setprecision(3)
+              << std::setw(14) << seconds * 1e6 / frames
+              << std::setw(14) << fired << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    int timerCount = argc > 1 ? std::stoi(argv[1]) : 200000;
+    int frames = argc > 2 ? std::stoi(argv[2]) : 3600;
+    const float dt = 1.0f / 60.0f;
+    
+    // Cooldowns and respawn delays between a tenth of a second and half a minute
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> intervalDist(0.1f, 30.0f);
+    std::vector<float> intervals(timerCount);
+    for (float& interval : intervals) {
+        interval = intervalDist(rng);
+    }
+    
+    std::cout << timerCount << " timers over " << frames << " frames at 60 FPS" << std::endl;
+    std::cout << std::left << std::setw(12) << "timers" << std::right
+              << std::setw(14) << "us/frame" << std::setw(14) << "fired" << std::endl;
+    
+    // Every timer is touched every frame
+    {
+        std::vector<float> remaining(intervals);
+        long long fired = 0;
+        auto start = SteadyClock::now();
+        for (int frame = 0; frame < frames; frame++) {
+            for (int i = 0; i < timerCount; i++) {
+                remaining[i] -= dt;
+                if (remaining[i] <= 0.0f) {
+                    remaining[i] += intervals[i];
+                    fired++;
+                }
+            }
+        }
+        double seconds = std::chrono::duration<double>(SteadyClock::now() - start).count();
+        printResult("countdown", seconds, frames, fired);
+    }
+    
+    // Only expiring timers are touched
+    {
+        TimerWheel wheel;
+        long long fired = 0;
+        for (int i = 0; i < timerCount; i++) {
+            wheel.scheduleRepeating(intervals[i], [&fired]() { fired++; });
+        }
+        auto start = SteadyClock::now();
+        for (int frame = 0; frame < frames; frame++) {
+            wheel.advance(dt);
+        }
+        double seconds = std::chrono::duration<double>(SteadyClock::now() - start).count();
+        printResult("TimerWheel", seconds, frames, fired);
+    }
+    
+    return 0;
+}
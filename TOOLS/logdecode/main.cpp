@@ -0,0 +1,209 @@
+#include "../ENGAIN/core/BinaryLog.h"
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace ENGAIN;
+
+// Converts a binary .blog file written by BinaryLog back into the text log
+// format: [YYYY-MM-DD HH:MM:SS] [LEVEL] message
+
+struct FormatDefinition {
+    int level;
+    std::string text;
+};
+
+const char* levelName(int level) {
+    switch (level) {
+        case 0:  return "DEBUG";
+        case 1:  return "INFO";
+        case 2:  return "WARNING";
+        case 3:  return "ERROR";
+        case 4:  return "CRITICAL";
+        default: return "UNKNOWN";
+    }
+}
+
+class Reader {
+public:
+    explicit Reader(const std::vector<char>& data) : data(data), pos(0) {}
+    
+    template <typename T>
+    bool read(T& value) {
+        if (pos + sizeof(T) > data.size()) return false;
+        std::memcpy(&value, data.data() + pos, sizeof(T));
+        pos += sizeof(T);
+        return true;
+    }
+    
+    bool readBytes(std::string& out, size_t length) {
+        if (pos + length > data.size()) return false;
+        out.assign(data.data() + pos, length);
+        pos += length;
+        return true;
+    }
+    
+    bool atEnd() const { return pos >= data.size(); }
+
+private:
+    const std::vector<char>& data;
+    size_t pos;
+};
+
+// Decode one argument and print it the way std::ostream would
+bool appendArgument(Reader& reader, std::ostringstream& out) {
+    uint8_t type;
+    if (!reader.read(type)) return false;
+    
+    switch (type) {
+        case BinaryLogFormat::ARG_INT: {
+            int64_t value;
+            if (!reader.read(value)) return false;
+            out << value;
+            return true;
+        }
+        case BinaryLogFormat::ARG_UINT: {
+            uint64_t value;
+            if (!reader.read(value)) return false;
+            out << value;
+            return true;
+        }
+        case BinaryLogFormat::ARG_DOUBLE: {
+            double value;
+            if (!reader.read(value)) return false;
+            out << value;
+            return true;
+        }
+        case BinaryLogFormat::ARG_STRING: {
+            uint16_t length;
+            std::string value;
+            if (!reader.read(length) || !reader.readBytes(value, length)) return false;
+            out << value;
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+std::string formatMessage(const std::string& format, const std::string& payload) {
+    std::vector<char> payloadData(payload.begin(), payload.end());
+    Reader args(payloadData);
+    std::ostringstream out;
+    
+    size_t cursor = 0;
+    for (;;) {
+        size_t placeholder = format.find("{}", cursor);
+        if (placeholder == std::string::npos || args.atEnd()) break;
+        
+        out.write(format.data() + cursor, placeholder - cursor);
+        if (!appendArgument(args, out)) {
+            out << "{?}";
+            cursor = placeholder + 2;
+            break;
+        }
+        cursor = placeholder + 2;
+    }
+    
+    out << format.substr(cursor);
+    return out.str();
+}
+
+std::string formatTimestamp(int64_t wallClockNs) {
+    std::time_t seconds = static_cast<std::time_t>(wallClockNs / 1000000000LL);
+    std::tm* localTime = std::localtime(&seconds);
+    
+    char text[32];
+    std::strftime(text, sizeof(text), "%Y-%m-%d %H:%M:%S", localTime);
+    return text;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: engain_logdecode <file.blog> [output.log]" << std::endl;
+        return 1;
+    }
+    
+    std::ifstream input(argv[1], std::ios::binary);
+    if (!input) {
+        std::cerr << "Failed to open " << argv[1] << std::endl;
+        return 1;
+    }
+    std::vector<char> data((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+    
+    std::ofstream outputFile;
+    if (argc > 2) {
+        outputFile.open(argv[2]);
+        if (!outputFile) {
+            std::cerr << "Failed to open " << argv[2] << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& output = argc > 2 ? static_cast<std::ostream&>(outputFile) : std::cout;
+    
+    Reader reader(data);
+    
+    // Header
+    char magic[sizeof(BinaryLogFormat::MAGIC)];
+    uint32_t version;
+    int64_t wallClockBase;
+    int64_t monotonicBase;
+    for (char& c : magic) {
+        if (!reader.read(c)) break;
+    }
+    if (std::memcmp(magic, BinaryLogFormat::MAGIC, sizeof(magic)) != 0 ||
+        !reader.read(version) || !reader.read(wallClockBase) || !reader.read(monotonicBase)) {
+        std::cerr << argv[1] << " is not an ENGAIN binary log" << std::endl;
+        return 1;
+    }
+    if (version != BinaryLogFormat::VERSION) {
+        std::cerr << "Unsupported binary log version " << version << std::endl;
+        return 1;
+    }
+    
+    std::unordered_map<uint32_t, FormatDefinition> formats;
+    size_t messages = 0;
+    
+    while (!reader.atEnd()) {
+        uint8_t recordType;
+        uint32_t id;
+        if (!reader.read(recordType) || !reader.read(id)) break;
+        
+        if (recordType == BinaryLogFormat::FORMAT_RECORD) {
+            uint8_t level;
+            uint16_t length;
+            FormatDefinition definition;
+            if (!reader.read(level) || !reader.read(length) || !reader.readBytes(definition.text, length)) break;
+            definition.level = level;
+            formats[id] = definition;
+        } else if (recordType == BinaryLogFormat::MESSAGE_RECORD) {
+            int64_t timestamp;
+            uint16_t length;
+            std::string payload;
+            if (!reader.read(timestamp) || !reader.read(length) || !reader.readBytes(payload, length)) break;
+            
+            auto it = formats.find(id);
+            if (it == formats.end()) {
+                std::cerr << "Message references unknown format " << id << std::endl;
+                continue;
+            }
+            
+            output << "[" << formatTimestamp(wallClockBase + (timestamp - monotonicBase)) << "] ["
+                   << levelName(it->second.level) << "] "
+                   << formatMessage(it->second.text, payload) << "\n";
+            messages++;
+        } else {
+            std::cerr << "Corrupt record at message " << messages << ", stopping" << std::endl;
+            break;
+        }
+    }
+    
+    std::cerr << "Decoded " << messages << " messages (" << data.size() << " bytes)" << std::endl;
+    return 0;
+}